@@ -0,0 +1,71 @@
+// Event copy cost per size class: copy_event<Log2> (the kernel the ring uses
+// for power-of-2 events) against a runtime-sized memcpy of the same bytes.
+//
+// Source and destination stay cache-resident, so the numbers isolate the
+// copy itself rather than memory bandwidth.
+//
+// Build: g++ -std=c++17 -O2 -I.. copy_kernels.cpp -o copy_kernels
+// Usage: ./copy_kernels [iterations=2000000]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "hftshm/copy.hpp"
+
+using namespace hftshm;
+
+namespace {
+
+inline constexpr uint8_t MIN_LOG2 = 3;
+inline constexpr uint8_t MAX_LOG2 = 13;
+
+alignas(64) char src[std::size_t{1} << MAX_LOG2];
+alignas(64) char dst[std::size_t{1} << MAX_LOG2];
+
+auto now_ns() -> uint64_t {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+template <typename F>
+auto time_copies(F&& copy, uint64_t iterations) -> double {
+    uint64_t start = now_ns();
+    for (uint64_t i = 0; i < iterations; ++i) {
+        copy();
+        asm volatile("" : : "r"(dst) : "memory");
+    }
+    return static_cast<double>(now_ns() - start) / static_cast<double>(iterations);
+}
+
+// Defeat constant propagation of the memcpy size
+volatile std::size_t runtime_size;
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint64_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+    std::memset(src, 0x5A, sizeof(src));
+
+    const CpuFeatures& f = cpu_features();
+    std::printf("cpu: sse2=%d avx2=%d avx512f=%d erms=%d\n", f.sse2, f.avx2, f.avx512f, f.erms);
+    std::printf("%8s %14s %14s\n", "size", "copy_event ns", "memcpy ns");
+
+    for (uint8_t log2 = MIN_LOG2; log2 <= MAX_LOG2; ++log2) {
+        const std::size_t size = std::size_t{1} << log2;
+        event_copy_fn kernel = event_copy_kernel(log2);
+        runtime_size = size;
+
+        double best_kernel = 1e18;
+        double best_memcpy = 1e18;
+        for (int round = 0; round < 3; ++round) {
+            best_kernel = std::min(best_kernel, time_copies([&] { kernel(dst, src); }, iterations));
+            best_memcpy = std::min(best_memcpy, time_copies([&] { std::memcpy(dst, src, runtime_size); }, iterations));
+        }
+        std::printf("%8zu %14.2f %14.2f\n", size, best_kernel, best_memcpy);
+    }
+    return 0;
+}
@@ -0,0 +1,114 @@
+// Consumer catch-up throughput with and without slot prefetching.
+//
+// The producer fills a ring much larger than the last-level cache, then the
+// consumer drains it, so every slot is a memory miss unless prefetched. Each
+// line reports ns/event for one prefetch distance, every run draining through
+// poll() so only the prefetching differs; "none" is PREFETCH_OFF and "auto"
+// is RingConsumer's default.
+//
+// Build: g++ -std=c++17 -O2 -I.. ring_prefetch.cpp -o ring_prefetch
+// Usage: ./ring_prefetch [event_size=64] [buffer_mb=256] [rounds=5]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "hftshm/ring.hpp"
+
+using namespace hftshm;
+
+namespace {
+
+struct Ring {
+    void* header;
+    void* data;
+};
+
+auto make_ring(uint16_t event_size, uint32_t buffer_size) -> Ring {
+    uint32_t header_size = header_segment_size(1);
+    Ring r{std::aligned_alloc(PAGE_SIZE, header_size), std::aligned_alloc(PAGE_SIZE, buffer_size)};
+    std::memset(r.header, 0, header_size);
+    std::memset(r.data, 0, buffer_size);
+    metadata_init(r.header, 1, event_size, buffer_size,
+                  default_producer_offset(), default_consumer_0_offset(), header_size);
+    sections_init(r.header);
+    return r;
+}
+
+// Publish one full ring of events
+auto fill(RingProducer& prod) -> void {
+    uint64_t slots = slot_count(prod.meta());
+    for (uint64_t i = 0; i < slots; ++i) {
+        auto* slot = static_cast<uint64_t*>(prod.try_claim());
+        *slot = i;
+        prod.publish();
+    }
+}
+
+// Push the ring out of cache before the consumer reads it
+auto evict(const Ring& r) -> void {
+    std::size_t size = metadata_get(r.header)->buffer_size;
+    std::vector<char> scratch(size);
+    std::memset(scratch.data(), 1, size);
+    asm volatile("" : : "r"(scratch.data()) : "memory");
+}
+
+auto now_ns() -> uint64_t {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// distance: slots ahead, 0 for auto or PREFETCH_OFF
+auto run(const Ring& r, uint32_t distance) -> double {
+    RingProducer prod(r.header, r.data);
+    RingConsumer cons(r.header, r.data, 0);
+    cons.attach();
+    fill(prod);
+    evict(r);
+
+    uint64_t sum = 0;
+    cons.set_prefetch_distance(distance);
+    uint64_t start = now_ns();
+    uint64_t n = cons.poll([&](const void* ev) { sum += *static_cast<const uint64_t*>(ev); });
+    uint64_t elapsed = now_ns() - start;
+    cons.detach();
+    asm volatile("" : : "r"(sum));
+    return static_cast<double>(elapsed) / static_cast<double>(n);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint16_t event_size = argc > 1 ? static_cast<uint16_t>(std::atoi(argv[1])) : 64;
+    uint32_t buffer_mb = argc > 2 ? static_cast<uint32_t>(std::atoi(argv[2])) : 256;
+    int rounds = argc > 3 ? std::atoi(argv[3]) : 5;
+    if (!is_power_of_2(event_size) || event_size < sizeof(uint64_t) || !is_power_of_2(buffer_mb)) {
+        std::fprintf(stderr, "event_size and buffer_mb must be powers of 2, event_size >= 8\n");
+        return 1;
+    }
+
+    Ring r = make_ring(event_size, buffer_mb << 20);
+    std::printf("event_size=%u buffer=%uMB slots=%u\n", event_size, buffer_mb,
+                slot_count(metadata_get(r.header)));
+
+    const uint32_t distances[] = {PREFETCH_OFF, 1, 2, 4, 8, 16, 32, 0};
+    for (uint32_t d : distances) {
+        double best = 1e18;
+        for (int i = 0; i < rounds; ++i) best = std::min(best, run(r, d));
+        if (d == PREFETCH_OFF) {
+            std::printf("  %-6s %7.2f ns/event\n", "none", best);
+        } else if (d == 0) {
+            std::printf("  %-6s %7.2f ns/event\n", "auto", best);
+        } else {
+            std::printf("  %-6u %7.2f ns/event\n", d, best);
+        }
+    }
+
+    std::free(r.header);
+    std::free(r.data);
+    return 0;
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "ring.hpp"
+
+namespace hftshm {
+
+// ============================================================================
+// Annotation Schema
+// ============================================================================
+
+// Pipeline stages (see RingConsumer::set_dependencies) can write derived
+// fields into reserved bytes of the slots they hold, for downstream stages to
+// read in place. Each stage owns at most one byte range per slot, recorded in
+// its consumer section; ranges never overlap. Ownership follows the
+// dependency order: the owner writes only while it holds the event (before
+// advancing past it), and only consumers downstream of the owner may read the
+// range, because they see the event strictly after the owner released it.
+
+inline constexpr uint32_t annotation_range(uint16_t offset, uint16_t length) {
+    return (uint32_t{offset} << 16) | length;
+}
+inline constexpr uint16_t annotation_offset(uint32_t range) { return static_cast<uint16_t>(range >> 16); }
+inline constexpr uint16_t annotation_length(uint32_t range) { return static_cast<uint16_t>(range); }
+
+// Attached upstreams of consumer `id` that gate it (see read_barrier()):
+// ids past max_consumers and detached sections are left out
+inline uint64_t gating_upstreams(void* header, uint8_t id) {
+    uint64_t mask = consumer_get(header, id)->depends.load(std::memory_order_acquire) &
+                    consumer_id_mask(metadata_get(header));
+    for (uint64_t m = mask; m; m &= m - 1) {
+        auto up = static_cast<uint8_t>(__builtin_ctzll(m));
+        if (consumer_get(header, up)->pid.load(std::memory_order_acquire) == 0) mask &= ~(uint64_t{1} << up);
+    }
+    return mask;
+}
+
+// Every consumer `id` transitively waits for, following only gating upstreams
+inline uint64_t upstream_mask(void* header, uint8_t id) {
+    uint64_t mask = gating_upstreams(header, id);
+    for (uint64_t seen = 0; mask != seen;) {
+        uint64_t added = mask & ~seen;
+        seen = mask;
+        for (; added; added &= added - 1) {
+            mask |= gating_upstreams(header, static_cast<uint8_t>(__builtin_ctzll(added)));
+        }
+    }
+    if (id <= MAX_DEPENDENCY_ID) mask &= ~(uint64_t{1} << id);
+    return mask;
+}
+
+// Record [offset, offset + length) of every slot as owned by consumer `id`.
+// Fails if the range leaves the event or overlaps another consumer's range.
+// Claims are made at pipeline setup, one stage at a time.
+inline bool annotation_claim(void* header, uint8_t id, uint16_t offset, uint16_t length) {
+    auto* meta = static_cast<const metadata*>(header);
+    if (length == 0 || uint32_t{offset} + length > meta->event_size) return false;
+    for (uint8_t i = 0; i < meta->max_consumers; ++i) {
+        if (i == id) continue;
+        uint32_t other = consumer_get(header, i)->annotation.load(std::memory_order_acquire);
+        if (other == 0) continue;
+        uint32_t lo = annotation_offset(other);
+        uint32_t hi = lo + annotation_length(other);
+        if (offset < hi && lo < uint32_t{offset} + length) return false;
+    }
+    consumer_get(header, id)->annotation.store(annotation_range(offset, length), std::memory_order_release);
+    return true;
+}
+
+inline void annotation_release(void* header, uint8_t id) {
+    consumer_get(header, id)->annotation.store(0, std::memory_order_release);
+}
+
+// ============================================================================
+// Annotator (owning stage)
+// ============================================================================
+
+class Annotator {
+public:
+    // `stage` must be the RingConsumer bound to section `id`
+    Annotator(RingConsumer& stage, void* header, uint8_t id)
+        : stage_(stage),
+          range_(consumer_get(header, id)->annotation.load(std::memory_order_acquire)) {}
+
+    // Writable annotation bytes of `sequence`, or nullptr unless the stage
+    // owns a range and currently holds the event (read but not yet advanced)
+    auto annotate(uint64_t sequence) -> void* {
+        if (range_ == 0 || sequence - stage_.sequence() >= stage_.available()) return nullptr;
+        return const_cast<char*>(static_cast<const char*>(stage_.slot(sequence))) + annotation_offset(range_);
+    }
+
+    // Same, from an event pointer handed out by poll()/peek()
+    auto annotate(const void* event) -> void* {
+        return range_ ? const_cast<char*>(static_cast<const char*>(event)) + annotation_offset(range_) : nullptr;
+    }
+
+    auto length() const -> uint16_t { return annotation_length(range_); }
+
+private:
+    RingConsumer& stage_;
+    uint32_t range_;
+};
+
+// ============================================================================
+// Annotation Reader (downstream stage)
+// ============================================================================
+
+class AnnotationReader {
+public:
+    AnnotationReader(void* header, uint8_t reader_id)
+        : header_(header), upstream_(upstream_mask(header, reader_id)) {}
+
+    // Annotation `owner` wrote into `event`, or nullptr if `owner` owns no
+    // range or is not upstream of this reader (its writes would race)
+    auto get(const void* event, uint8_t owner) const -> const void* {
+        if (owner > MAX_DEPENDENCY_ID || !(upstream_ >> owner & 1)) return nullptr;
+        uint32_t range = consumer_get(header_, owner)->annotation.load(std::memory_order_relaxed);
+        return range ? static_cast<const char*>(event) + annotation_offset(range) : nullptr;
+    }
+
+    // Re-read the dependency graph after stages change
+    auto refresh(uint8_t reader_id) -> void { upstream_ = upstream_mask(header_, reader_id); }
+
+private:
+    void* header_;
+    uint64_t upstream_;
+};
+
+} // namespace hftshm
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include "hash.hpp"
+#include "lvc.hpp"
+#include "ring.hpp"
+
+namespace hftshm {
+
+// ============================================================================
+// Bar Events
+// ============================================================================
+
+// Field offsets of a trade event on the input ring; each field must lie
+// within the ring's event_size
+struct TradeFields {
+    uint16_t key_offset;      // uint32_t instrument key
+    uint16_t time_offset;     // uint64_t timestamp (ns)
+    uint16_t price_offset;    // int64_t price (ticks)
+    uint16_t qty_offset;      // int64_t quantity
+};
+
+// OHLCV bar; published on the output ring when it closes and kept current
+// in the last-value cache (value_size == sizeof(bar_event)) on every trade
+struct bar_event {
+    uint32_t key;                     // 0x00: Instrument key
+    uint32_t trades;                  // 0x04: Trades in the bar
+    uint64_t start;                   // 0x08: Bar start time (ns, multiple of interval)
+    uint64_t interval;                // 0x10: Bar length (ns)
+    int64_t  open;                    // 0x18
+    int64_t  high;                    // 0x20
+    int64_t  low;                     // 0x28
+    int64_t  close;                   // 0x30
+    int64_t  volume;                  // 0x38
+};
+static_assert(sizeof(bar_event) == 64);
+
+// ============================================================================
+// Bar Aggregator
+// ============================================================================
+
+// Consumes a trade ring and builds fixed-interval bars per instrument,
+// updated incrementally per trade. A bar closes when the first trade of a
+// later interval arrives, or on close_until() for instruments that went
+// quiet. Trades older than the open bar are folded into it.
+//
+// Memory is fixed at construction: per-key state for up to max_keys
+// instruments; trades for further keys are counted in dropped() and skipped.
+// Run one aggregator per interval (e.g. 1s and 1m), each with its own
+// consumer section, output ring and LVC. The constructor throws
+// std::invalid_argument for a zero interval, a TradeFields field past the
+// input ring's event_size, an output ring whose events can't hold a
+// bar_event, or an LVC whose value_size isn't sizeof(bar_event).
+class BarAggregator {
+public:
+    BarAggregator(void* in_header, void* in_data, uint8_t consumer_id,
+                  void* out_header, void* out_data, void* lvc,
+                  uint64_t interval_ns, uint32_t max_keys, TradeFields fields)
+        : in_(in_header, in_data, consumer_id),
+          out_(out_header, out_data),
+          lvc_(lvc),
+          has_lvc_(lvc != nullptr),
+          interval_(interval_ns),
+          fields_(fields),
+          states_(next_power_of_2(max_keys * 2)),
+          mask_(static_cast<uint32_t>(states_.size() - 1)),
+          count_(0),
+          max_keys_(max_keys),
+          dropped_(0) {
+        if (interval_ == 0) {
+            throw std::invalid_argument("hftshm: bar interval must be nonzero");
+        }
+        const uint32_t in_size = metadata_get(in_header)->event_size;
+        if (fields_.key_offset + sizeof(uint32_t) > in_size || fields_.time_offset + sizeof(uint64_t) > in_size ||
+            fields_.price_offset + sizeof(int64_t) > in_size || fields_.qty_offset + sizeof(int64_t) > in_size) {
+            throw std::invalid_argument("hftshm: bar trade field past the input ring's event_size");
+        }
+        if (metadata_get(out_header)->event_size < sizeof(bar_event)) {
+            throw std::invalid_argument("hftshm: bar output ring event_size < sizeof(bar_event)");
+        }
+        if (has_lvc_ && (!lvc_validate(lvc) || static_cast<const lvc_header*>(lvc)->value_size != sizeof(bar_event))) {
+            throw std::invalid_argument("hftshm: bar LVC value_size must be sizeof(bar_event)");
+        }
+    }
+
+    auto attach() -> void { in_.attach(); }
+    auto detach() -> void { in_.detach(); }
+
+    // Process up to max_events trades. Stops early, without consuming the
+    // trade, if a closing bar finds the output ring full.
+    auto poll(uint64_t max_events = UINT64_MAX) -> uint64_t {
+        uint64_t avail = std::min(in_.available(), max_events);
+        uint64_t n = 0;
+        for (; n < avail; ++n) {
+            if (!on_trade(static_cast<const char*>(in_.slot(in_.sequence() + n)))) break;
+        }
+        if (n) in_.advance(n);
+        return n;
+    }
+
+    // Publish every open bar whose interval ended at or before now_ns.
+    // Returns false if the output ring filled up first (call again later).
+    auto close_until(uint64_t now_ns) -> bool {
+        for (State& st : states_) {
+            if (st.bar.trades && st.bar.start + interval_ <= now_ns) {
+                if (!out_.try_write(&st.bar, sizeof(bar_event))) return false;
+                st.bar.trades = 0;
+            }
+        }
+        return true;
+    }
+
+    auto dropped() const -> uint64_t { return dropped_; }
+    auto input() -> RingConsumer& { return in_; }
+    auto output() -> RingProducer& { return out_; }
+
+private:
+    struct State {
+        uint64_t key_plus1 = 0;       // 0 = empty; 64-bit so every uint32_t key fits
+        lvc_entry* entry = nullptr;
+        bar_event bar{};
+    };
+
+    auto on_trade(const char* ev) -> bool {
+        uint32_t key;
+        uint64_t ts;
+        int64_t price;
+        int64_t qty;
+        std::memcpy(&key, ev + fields_.key_offset, sizeof(key));
+        std::memcpy(&ts, ev + fields_.time_offset, sizeof(ts));
+        std::memcpy(&price, ev + fields_.price_offset, sizeof(price));
+        std::memcpy(&qty, ev + fields_.qty_offset, sizeof(qty));
+
+        State* st = state(key);
+        if (!st) {
+            ++dropped_;
+            return true;
+        }
+
+        bar_event& bar = st->bar;
+        uint64_t start = ts - ts % interval_;
+        if (bar.trades && start > bar.start) {
+            if (!out_.try_write(&bar, sizeof(bar_event))) return false;
+            bar.trades = 0;
+        }
+
+        if (bar.trades == 0) {
+            bar = {key, 1, start, interval_, price, price, price, price, qty};
+        } else {
+            bar.high = std::max(bar.high, price);
+            bar.low = std::min(bar.low, price);
+            bar.close = price;
+            bar.volume += qty;
+            ++bar.trades;
+        }
+
+        if (st->entry) lvc_.update(st->entry, &bar);
+        return true;
+    }
+
+    auto state(uint32_t key) -> State* {
+        for (uint32_t i = key_hash(key) & mask_;; i = (i + 1) & mask_) {
+            State& st = states_[i];
+            if (st.key_plus1 == uint64_t{key} + 1) return &st;
+            if (st.key_plus1 == 0) {
+                if (count_ == max_keys_) return nullptr;
+                st.key_plus1 = uint64_t{key} + 1;
+                if (has_lvc_) st.entry = lvc_.entry(key);
+                ++count_;
+                return &st;
+            }
+        }
+    }
+
+    RingConsumer in_;
+    RingProducer out_;
+    LvcWriter lvc_;
+    bool has_lvc_;
+    uint64_t interval_;
+    TradeFields fields_;
+    std::vector<State> states_;       // Open-addressing table, load <= 50%
+    uint32_t mask_;
+    uint32_t count_;
+    uint32_t max_keys_;
+    uint64_t dropped_;
+};
+
+} // namespace hftshm
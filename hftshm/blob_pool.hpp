@@ -0,0 +1,195 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "layout.hpp"
+#include "ring.hpp"
+
+namespace hftshm {
+
+// ============================================================================
+// Blob Pool Segment Layout (<name>.blob)
+// ============================================================================
+
+// Magic number: "HFTBLOB\x01" in little-endian
+inline constexpr uint64_t BLOB_POOL_MAGIC = 0x01424F4C42544648ULL;
+
+inline constexpr uint32_t BLOB_MAX_CLASSES = 8;
+
+// Size class: blocks of one payload capacity, reused in allocation order.
+// A block is free again once every attached consumer of the owning ring has
+// read past the event that referenced it, so reclamation needs no refcounts.
+struct blob_class {
+    uint32_t payload_size;            // 0x00: Max payload bytes per block
+    uint32_t block_count;             // 0x04: Blocks in this class
+    uint32_t offset;                  // 0x08: Offset of block 0 from segment start
+    uint32_t next;                    // 0x0C: Next block to allocate (producer only)
+};
+
+struct alignas(CACHE_LINE) blob_pool_header {
+    uint64_t   magic;                 // 0x00: BLOB_POOL_MAGIC
+    uint32_t   class_count;           // 0x08
+    uint32_t   size;                  // 0x0C: Total segment size
+    blob_class classes[BLOB_MAX_CLASSES];
+};
+
+// Header in front of every block's payload
+struct blob_block {
+    std::atomic<uint32_t> generation; // 0x00: Bumped on every reuse
+    uint32_t length;                  // 0x04: Payload bytes
+    uint64_t release_seq;             // 0x08: Reusable once min consumer cursor >= this
+};
+inline constexpr uint32_t BLOB_BLOCK_HEADER_SIZE = sizeof(blob_block);
+static_assert(BLOB_BLOCK_HEADER_SIZE == 16);
+
+// Ring event payload referring to a blob
+struct blob_ref {
+    uint32_t offset;                  // 0x00: Payload offset from segment start
+    uint32_t length;                  // 0x04: Payload bytes
+    uint32_t generation;              // 0x08: Block generation at allocation
+    uint32_t reserved;                // 0x0C
+};
+static_assert(sizeof(blob_ref) == 16);
+
+// Requested size class for blob_pool_init()
+struct BlobClassSpec {
+    uint32_t payload_size;
+    uint32_t block_count;
+};
+
+inline uint32_t blob_block_size(uint32_t payload_size) {
+    uint32_t raw = BLOB_BLOCK_HEADER_SIZE + payload_size;
+    return ((raw + CACHE_LINE - 1) / CACHE_LINE) * CACHE_LINE;
+}
+
+// Calculate blob pool segment size (page-aligned)
+inline uint32_t blob_pool_size(const BlobClassSpec* specs, uint32_t count) {
+    uint32_t raw = sizeof(blob_pool_header);
+    for (uint32_t i = 0; i < count; ++i) {
+        raw += specs[i].block_count * blob_block_size(specs[i].payload_size);
+    }
+    return ((raw + PAGE_SIZE - 1) / PAGE_SIZE) * PAGE_SIZE;
+}
+
+// Initialize a pool; specs must be sorted by ascending payload_size, each
+// with at least one block
+inline bool blob_pool_init(void* pool, const BlobClassSpec* specs, uint32_t count) {
+    if (count == 0 || count > BLOB_MAX_CLASSES) return false;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (specs[i].block_count == 0) return false;
+        if (i > 0 && specs[i].payload_size < specs[i - 1].payload_size) return false;
+    }
+    auto* hdr = static_cast<blob_pool_header*>(pool);
+    std::memset(hdr, 0, sizeof(blob_pool_header));
+
+    uint32_t offset = sizeof(blob_pool_header);
+    for (uint32_t i = 0; i < count; ++i) {
+        hdr->classes[i] = {specs[i].payload_size, specs[i].block_count, offset, 0};
+        uint32_t block_size = blob_block_size(specs[i].payload_size);
+        std::memset(static_cast<char*>(pool) + offset, 0, std::size_t{block_size} * specs[i].block_count);
+        offset += block_size * specs[i].block_count;
+    }
+    hdr->class_count = count;
+    hdr->size = offset;
+    hdr->magic = BLOB_POOL_MAGIC;
+    return true;
+}
+
+inline bool blob_pool_validate(const void* pool) {
+    return static_cast<const blob_pool_header*>(pool)->magic == BLOB_POOL_MAGIC;
+}
+
+// ============================================================================
+// Blob Writer (producer side)
+// ============================================================================
+
+// Allocates blobs for events published on one ring. Single writer: the ring's
+// producer. O(1) allocation, no free lists: each class hands out its blocks
+// round-robin, gated on the owning ring's slowest consumer.
+class BlobWriter {
+public:
+    BlobWriter(void* pool, void* ring_header)
+        : pool_(static_cast<char*>(pool)),
+          hdr_(static_cast<blob_pool_header*>(pool)),
+          ring_header_(ring_header),
+          gate_(0) {}
+
+    // Allocate a blob for the event that will be published at `sequence`.
+    // Returns the payload pointer and fills `ref`, or nullptr if every block of
+    // a fitting class is still referenced by an unread event.
+    auto try_alloc(uint32_t length, uint64_t sequence, blob_ref& ref) -> void* {
+        for (uint32_t c = 0; c < hdr_->class_count; ++c) {
+            blob_class& cls = hdr_->classes[c];
+            if (cls.payload_size < length) continue;
+
+            uint32_t block_size = blob_block_size(cls.payload_size);
+            char* raw = pool_ + cls.offset + (cls.next % cls.block_count) * block_size;
+            auto* block = reinterpret_cast<blob_block*>(raw);
+            if (block->release_seq > gate_) {
+                gate_ = min_consumer_cursor(ring_header_, sequence);
+                if (block->release_seq > gate_) continue;   // Class exhausted, try larger
+            }
+
+            cls.next = (cls.next + 1) % cls.block_count;
+            block->length = length;
+            block->release_seq = sequence + 1;
+            uint32_t gen = block->generation.fetch_add(1, std::memory_order_relaxed) + 1;
+            // Order the bump before the caller's payload stores (as
+            // seqlock_write_begin() does); a release RMW alone doesn't
+            std::atomic_thread_fence(std::memory_order_release);
+
+            ref = {static_cast<uint32_t>(raw - pool_) + BLOB_BLOCK_HEADER_SIZE, length, gen, 0};
+            return raw + BLOB_BLOCK_HEADER_SIZE;
+        }
+        return nullptr;
+    }
+
+    // Allocate, copy `payload` in, and fill `ref`
+    auto try_write(const void* payload, uint32_t length, uint64_t sequence, blob_ref& ref) -> bool {
+        void* dst = try_alloc(length, sequence, ref);
+        if (!dst) return false;
+        std::memcpy(dst, payload, length);
+        return true;
+    }
+
+private:
+    char* pool_;
+    blob_pool_header* hdr_;
+    void* ring_header_;
+    uint64_t gate_;     // Cached min consumer cursor of the owning ring
+};
+
+// ============================================================================
+// Blob Reader (consumer side)
+// ============================================================================
+
+// Resolves blob_refs from ring events. A consumer's own cursor keeps a
+// referenced block alive until it advances past the event; the generation
+// check catches refs read after that point (e.g. from a detached consumer).
+class BlobReader {
+public:
+    explicit BlobReader(const void* pool)
+        : pool_(static_cast<const char*>(pool)) {}
+
+    // Payload pointer, or nullptr if the block has been reused
+    auto resolve(const blob_ref& ref) const -> const void* {
+        return valid(ref) ? pool_ + ref.offset : nullptr;
+    }
+
+    // Re-check after copying out of a blob that it wasn't reused meanwhile
+    auto valid(const blob_ref& ref) const -> bool {
+        auto* block = reinterpret_cast<const blob_block*>(pool_ + ref.offset - BLOB_BLOCK_HEADER_SIZE);
+        // Order the caller's payload loads before the generation load (as
+        // seqlock_read_retry() does); an acquire load alone doesn't
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return block->generation.load(std::memory_order_acquire) == ref.generation;
+    }
+
+private:
+    const char* pool_;
+};
+
+} // namespace hftshm
@@ -0,0 +1,297 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "copy.hpp"
+#include "layout.hpp"
+#include "seqlock.hpp"
+
+namespace hftshm {
+
+// ============================================================================
+// Order Book Segment Layout (<name>.book)
+// ============================================================================
+
+// Magic number: "HFTBOOK\x01" in little-endian
+inline constexpr uint64_t BOOK_MAGIC = 0x014B4F4F42544648ULL;
+
+// Price levels tracked per side; updates beyond this depth are dropped
+inline constexpr uint32_t BOOK_MAX_LEVELS = 32;
+
+// Prices are integer ticks. Unused levels hold a sentinel that sorts after
+// every real price, so searches can scan whole vectors without a count check.
+inline constexpr int64_t BOOK_BID_SENTINEL = INT64_MIN;
+inline constexpr int64_t BOOK_ASK_SENTINEL = INT64_MAX;
+
+enum class Side : uint8_t { Bid = 0, Ask = 1 };
+
+struct book_top {
+    int64_t bid_price;                // 0x00
+    int64_t bid_qty;                  // 0x08
+    int64_t ask_price;                // 0x10
+    int64_t ask_qty;                  // 0x18
+};
+
+// One instrument's L2 book, maintained by a single builder process.
+// Line 0 holds the seqlock and a copy of the top of book, so the common
+// reader query costs one cache miss. Prices per side are contiguous and
+// sorted best-first (bids descending, asks ascending) for SIMD search.
+struct alignas(CACHE_LINE) shm_book {
+    std::atomic<uint32_t> seq;        // 0x00: Seqlock over the whole book
+    uint32_t key;                     // 0x04: Instrument key
+    uint32_t bid_count;               // 0x08
+    uint32_t ask_count;               // 0x0C
+    uint64_t update_seq;              // 0x10: Feed sequence of the last applied update
+    uint64_t reserved;                // 0x18
+    book_top top;                     // 0x20: Copy of level 0 on each side
+    alignas(CACHE_LINE) int64_t bid_price[BOOK_MAX_LEVELS];
+    int64_t ask_price[BOOK_MAX_LEVELS];
+    int64_t bid_qty[BOOK_MAX_LEVELS];
+    int64_t ask_qty[BOOK_MAX_LEVELS];
+};
+
+struct alignas(CACHE_LINE) book_segment_header {
+    uint64_t magic;                   // 0x00: BOOK_MAGIC
+    uint32_t capacity;                // 0x08: Books in the segment
+    uint32_t max_levels;              // 0x0C: BOOK_MAX_LEVELS at creation
+};
+
+// Calculate order book segment size (page-aligned)
+inline std::size_t book_segment_size(uint32_t capacity) {
+    std::size_t raw = sizeof(book_segment_header) + std::size_t{capacity} * sizeof(shm_book);
+    return ((raw + PAGE_SIZE - 1) / PAGE_SIZE) * PAGE_SIZE;
+}
+
+inline shm_book* book_get(void* segment, uint32_t index) {
+    return reinterpret_cast<shm_book*>(static_cast<char*>(segment) + sizeof(book_segment_header)) + index;
+}
+
+inline const shm_book* book_get(const void* segment, uint32_t index) {
+    return book_get(const_cast<void*>(segment), index);
+}
+
+inline void book_clear(shm_book* b) {
+    b->bid_count = 0;
+    b->ask_count = 0;
+    b->top = {BOOK_BID_SENTINEL, 0, BOOK_ASK_SENTINEL, 0};
+    for (uint32_t i = 0; i < BOOK_MAX_LEVELS; ++i) {
+        b->bid_price[i] = BOOK_BID_SENTINEL;
+        b->ask_price[i] = BOOK_ASK_SENTINEL;
+        b->bid_qty[i] = 0;
+        b->ask_qty[i] = 0;
+    }
+}
+
+inline bool book_init(void* segment, uint32_t capacity) {
+    if (capacity == 0) return false;
+    auto* hdr = static_cast<book_segment_header*>(segment);
+    hdr->capacity = capacity;
+    hdr->max_levels = BOOK_MAX_LEVELS;
+    for (uint32_t i = 0; i < capacity; ++i) {
+        shm_book* b = book_get(segment, i);
+        b->seq.store(0, std::memory_order_relaxed);
+        b->key = i;
+        b->update_seq = 0;
+        b->reserved = 0;
+        book_clear(b);
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    hdr->magic = BOOK_MAGIC;
+    return true;
+}
+
+inline bool book_validate(const void* segment) {
+    auto* hdr = static_cast<const book_segment_header*>(segment);
+    return hdr->magic == BOOK_MAGIC && hdr->max_levels == BOOK_MAX_LEVELS;
+}
+
+// ============================================================================
+// Price Level Search
+// ============================================================================
+
+namespace detail {
+
+// Index of the first level not better than `price` in a padded
+// BOOK_MAX_LEVELS array: the level itself if present, else its insert position
+inline auto level_search_scalar(const int64_t* prices, int64_t price, bool bid) -> uint32_t {
+    uint32_t i = 0;
+    if (bid) {
+        while (i < BOOK_MAX_LEVELS && prices[i] > price) ++i;
+    } else {
+        while (i < BOOK_MAX_LEVELS && prices[i] < price) ++i;
+    }
+    return i;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+__attribute__((target("avx2")))
+inline auto level_search_avx2(const int64_t* prices, int64_t price, bool bid) -> uint32_t {
+    const __m256i p = _mm256_set1_epi64x(price);
+    for (uint32_t i = 0; i < BOOK_MAX_LEVELS; i += 4) {
+        __m256i v = _mm256_load_si256(reinterpret_cast<const __m256i*>(prices + i));
+        __m256i better = bid ? _mm256_cmpgt_epi64(v, p) : _mm256_cmpgt_epi64(p, v);
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(better)));
+        if (mask != 0xF) return i + static_cast<uint32_t>(__builtin_ctz(~mask));
+    }
+    return BOOK_MAX_LEVELS;
+}
+
+#endif
+
+inline auto level_search(const int64_t* prices, int64_t price, bool bid) -> uint32_t {
+#if defined(__x86_64__) || defined(__i386__)
+    if (cpu_features().avx2) return level_search_avx2(prices, price, bid);
+#endif
+    return level_search_scalar(prices, price, bid);
+}
+
+} // namespace detail
+
+static_assert(BOOK_MAX_LEVELS % 4 == 0);
+static_assert(offsetof(shm_book, bid_price) % 32 == 0 && offsetof(shm_book, ask_price) % 32 == 0);
+
+// ============================================================================
+// Book Builder (single writer)
+// ============================================================================
+
+// Applies L2 updates to books in the segment. Edits between begin() and
+// commit() are published atomically to readers under the book's seqlock,
+// so a batch of level changes from one feed message is never seen half-done.
+class BookBuilder {
+public:
+    explicit BookBuilder(void* segment)
+        : segment_(segment), book_(nullptr), seq_(0) {}
+
+    auto begin(uint32_t index) -> void {
+        book_ = book_get(segment_, index);
+        seq_ = seqlock_write_begin(book_->seq);
+    }
+
+    // Set a level's quantity; qty 0 removes it. Returns false if the price
+    // falls beyond BOOK_MAX_LEVELS and was dropped.
+    auto set_level(Side side, int64_t price, int64_t qty) -> bool {
+        bool bid = side == Side::Bid;
+        int64_t* px = bid ? book_->bid_price : book_->ask_price;
+        int64_t* qs = bid ? book_->bid_qty : book_->ask_qty;
+        uint32_t& n = bid ? book_->bid_count : book_->ask_count;
+
+        uint32_t i = detail::level_search(px, price, bid);
+        if (i < n && px[i] == price) {
+            if (qty) {
+                qs[i] = qty;
+            } else {
+                std::memmove(px + i, px + i + 1, (n - i - 1) * sizeof(int64_t));
+                std::memmove(qs + i, qs + i + 1, (n - i - 1) * sizeof(int64_t));
+                --n;
+                px[n] = bid ? BOOK_BID_SENTINEL : BOOK_ASK_SENTINEL;
+                qs[n] = 0;
+            }
+            return true;
+        }
+        if (!qty) return true;
+        if (i == BOOK_MAX_LEVELS) return false;
+
+        // Insert; a full side drops its worst level
+        uint32_t last = n < BOOK_MAX_LEVELS ? n : BOOK_MAX_LEVELS - 1;
+        std::memmove(px + i + 1, px + i, (last - i) * sizeof(int64_t));
+        std::memmove(qs + i + 1, qs + i, (last - i) * sizeof(int64_t));
+        px[i] = price;
+        qs[i] = qty;
+        if (n < BOOK_MAX_LEVELS) ++n;
+        return true;
+    }
+
+    // Drop every level (e.g. before applying a snapshot)
+    auto clear() -> void { book_clear(book_); }
+
+    // Publish the batch; update_seq records the feed sequence it reflects
+    auto commit(uint64_t update_seq) -> void {
+        book_->top = {book_->bid_price[0], book_->bid_qty[0], book_->ask_price[0], book_->ask_qty[0]};
+        book_->update_seq = update_seq;
+        seqlock_write_end(book_->seq, seq_);
+        book_ = nullptr;
+    }
+
+private:
+    void* segment_;
+    shm_book* book_;     // Book open between begin() and commit()
+    uint32_t seq_;
+};
+
+// ============================================================================
+// Book Reader
+// ============================================================================
+
+// Process-local copy of the top levels of a book
+struct BookSnapshot {
+    uint32_t bid_count = 0;
+    uint32_t ask_count = 0;
+    uint64_t update_seq = 0;
+    int64_t bid_price[BOOK_MAX_LEVELS];
+    int64_t bid_qty[BOOK_MAX_LEVELS];
+    int64_t ask_price[BOOK_MAX_LEVELS];
+    int64_t ask_qty[BOOK_MAX_LEVELS];
+};
+
+class BookReader {
+public:
+    explicit BookReader(const void* segment)
+        : segment_(segment) {}
+
+    // Best bid and ask (one cache line); sentinel prices mean an empty side
+    auto top(uint32_t index, book_top& out, uint32_t max_attempts = SEQLOCK_READ_ATTEMPTS) const -> bool {
+        const shm_book* b = book_get(segment_, index);
+        return seqlock_copy(b->seq, &out, &b->top, sizeof(book_top), max_attempts);
+    }
+
+    // Copy up to `levels` levels per side
+    auto snapshot(uint32_t index, BookSnapshot& out, uint32_t levels = BOOK_MAX_LEVELS,
+                  uint32_t max_attempts = SEQLOCK_READ_ATTEMPTS) const -> bool {
+        const shm_book* b = book_get(segment_, index);
+        if (levels > BOOK_MAX_LEVELS) levels = BOOK_MAX_LEVELS;
+        const std::size_t bytes = levels * sizeof(int64_t);
+        for (uint32_t attempt = 0; attempt < max_attempts; ++attempt) {
+            uint32_t s = seqlock_read_begin(b->seq);
+            out.bid_count = b->bid_count < levels ? b->bid_count : levels;
+            out.ask_count = b->ask_count < levels ? b->ask_count : levels;
+            out.update_seq = b->update_seq;
+            std::memcpy(out.bid_price, b->bid_price, bytes);
+            std::memcpy(out.bid_qty, b->bid_qty, bytes);
+            std::memcpy(out.ask_price, b->ask_price, bytes);
+            std::memcpy(out.ask_qty, b->ask_qty, bytes);
+            if (!seqlock_read_retry(b->seq, s)) return true;
+            cpu_relax();
+        }
+        return false;
+    }
+
+    // Quantity resting at `price` (0 if no such level); false on contention
+    auto qty_at(uint32_t index, Side side, int64_t price, int64_t& qty,
+                uint32_t max_attempts = SEQLOCK_READ_ATTEMPTS) const -> bool {
+        const shm_book* b = book_get(segment_, index);
+        bool bid = side == Side::Bid;
+        const int64_t* px = bid ? b->bid_price : b->ask_price;
+        const int64_t* qs = bid ? b->bid_qty : b->ask_qty;
+        for (uint32_t attempt = 0; attempt < max_attempts; ++attempt) {
+            uint32_t s = seqlock_read_begin(b->seq);
+            uint32_t i = detail::level_search(px, price, bid);
+            qty = i < BOOK_MAX_LEVELS && px[i] == price ? qs[i] : 0;
+            if (!seqlock_read_retry(b->seq, s)) return true;
+            cpu_relax();
+        }
+        return false;
+    }
+
+    auto capacity() const -> uint32_t {
+        return static_cast<const book_segment_header*>(segment_)->capacity;
+    }
+
+private:
+    const void* segment_;
+};
+
+} // namespace hftshm
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include "ring.hpp"
+#include "wait.hpp"
+
+namespace hftshm {
+
+// ============================================================================
+// Channel Message Layout
+// ============================================================================
+
+// Every request and response slot starts with this header; the payload
+// follows and is at most event_size - CHANNEL_HEADER_SIZE bytes.
+struct channel_header {
+    uint64_t correlation_id;          // 0x00: Assigned by the client, echoed by the server
+    uint32_t size;                    // 0x08: Payload bytes
+    uint32_t reserved;                // 0x0C
+};
+inline constexpr uint32_t CHANNEL_HEADER_SIZE = sizeof(channel_header);
+static_assert(CHANNEL_HEADER_SIZE == 16);
+
+// Responses a client can hold while waiting for a different correlation id
+inline constexpr std::size_t CHANNEL_MAX_PENDING = 16;
+
+// Returned by wait_for() on timeout
+inline constexpr int32_t CHANNEL_TIMEOUT = -1;
+
+// Channel rings must be fixed-size with room for the header in every slot
+inline bool channel_validate(const void* header) {
+    return metadata_get(header)->event_size >= CHANNEL_HEADER_SIZE;
+}
+
+namespace detail {
+
+inline auto channel_check(const void* req_header, const void* resp_header) -> void {
+    if (!channel_validate(req_header) || !channel_validate(resp_header)) {
+        throw std::invalid_argument("hftshm: channel rings need event_size >= CHANNEL_HEADER_SIZE");
+    }
+}
+
+inline auto channel_write(RingProducer& ring, uint64_t correlation_id,
+                          const void* payload, uint32_t size) -> bool {
+    void* slot = ring.try_claim();
+    if (!slot) return false;
+    size = std::min<uint32_t>(size, ring.meta()->event_size - CHANNEL_HEADER_SIZE);
+    channel_header hdr{correlation_id, size, 0};
+    std::memcpy(slot, &hdr, CHANNEL_HEADER_SIZE);
+    std::memcpy(static_cast<char*>(slot) + CHANNEL_HEADER_SIZE, payload, size);
+    ring.publish();
+    return true;
+}
+
+} // namespace detail
+
+// ============================================================================
+// Channel Client
+// ============================================================================
+
+// Client end of a duplex channel: producer on the request ring, consumer
+// `consumer_id` on the response ring. One ring pair per client.
+//
+// Responses for other correlation ids are stashed until asked for, up to
+// CHANNEL_MAX_PENDING; beyond that the oldest is discarded and counted in
+// dropped(), and waiting on its id times out.
+class ChannelClient {
+public:
+    ChannelClient(void* req_header, void* req_data,
+                  void* resp_header, void* resp_data, uint8_t consumer_id)
+        : requests_(req_header, req_data),
+          responses_(resp_header, resp_data, consumer_id),
+          slot_size_(metadata_get(resp_header)->event_size),
+          stash_(CHANNEL_MAX_PENDING * slot_size_) {
+        detail::channel_check(req_header, resp_header);
+        responses_.attach();
+    }
+
+    // Send a request; returns its correlation id, or 0 if the request ring is full
+    auto send(const void* payload, uint32_t size) -> uint64_t {
+        uint64_t id = next_id_;
+        if (!detail::channel_write(requests_, id, payload, size)) return 0;
+        ++next_id_;
+        return id;
+    }
+
+    // Copy the response for `correlation_id` into out (capacity bytes) if it has
+    // arrived. Returns the payload size, or CHANNEL_TIMEOUT if not yet received.
+    auto try_receive(uint64_t correlation_id, void* out, uint32_t capacity) -> int32_t {
+        for (std::size_t i = 0; i < pending_; ++i) {
+            auto* hdr = reinterpret_cast<const channel_header*>(stash_slot(i));
+            if (hdr->correlation_id != correlation_id) continue;
+            int32_t n = deliver(hdr, out, capacity);
+            unstash(i);
+            return n;
+        }
+
+        while (const void* slot = responses_.peek()) {
+            auto* hdr = static_cast<const channel_header*>(slot);
+            if (hdr->correlation_id == correlation_id) {
+                int32_t n = deliver(hdr, out, capacity);
+                responses_.advance();
+                return n;
+            }
+            // Keep responses for other outstanding requests; drop the oldest on overflow
+            if (pending_ == CHANNEL_MAX_PENDING) {
+                unstash(0);
+                ++dropped_;
+            }
+            std::memcpy(stash_slot(pending_++), slot, slot_size_);
+            responses_.advance();
+        }
+        return CHANNEL_TIMEOUT;
+    }
+
+    // Wait for the response to `correlation_id` using a wait strategy
+    template <typename Wait = BusySpinWait>
+    auto wait_for(uint64_t correlation_id, void* out, uint32_t capacity,
+                  std::chrono::nanoseconds timeout, const Wait& wait = Wait{}) -> int32_t {
+        int32_t n = CHANNEL_TIMEOUT;
+        wait_until([&] { return (n = try_receive(correlation_id, out, capacity)) != CHANNEL_TIMEOUT; },
+                   wait, timeout);
+        return n;
+    }
+
+    // Send a request and wait for its response
+    template <typename Wait = BusySpinWait>
+    auto call(const void* request, uint32_t size, void* out, uint32_t capacity,
+              std::chrono::nanoseconds timeout, const Wait& wait = Wait{}) -> int32_t {
+        uint64_t id = send(request, size);
+        if (id == 0) return CHANNEL_TIMEOUT;
+        return wait_for(id, out, capacity, timeout, wait);
+    }
+
+    // Stashed responses discarded because CHANNEL_MAX_PENDING were already held
+    auto dropped() const -> uint64_t { return dropped_; }
+
+private:
+    static auto deliver(const channel_header* hdr, void* out, uint32_t capacity) -> int32_t {
+        uint32_t n = std::min(hdr->size, capacity);
+        std::memcpy(out, reinterpret_cast<const char*>(hdr) + CHANNEL_HEADER_SIZE, n);
+        return static_cast<int32_t>(n);
+    }
+
+    auto stash_slot(std::size_t i) -> char* { return stash_.data() + i * slot_size_; }
+
+    auto unstash(std::size_t i) -> void {
+        std::memmove(stash_slot(i), stash_slot(i + 1), (pending_ - i - 1) * slot_size_);
+        --pending_;
+    }
+
+    RingProducer requests_;
+    RingConsumer responses_;
+    uint32_t slot_size_;
+    uint64_t next_id_ = 1;
+    std::vector<char> stash_;       // Out-of-order responses, CHANNEL_MAX_PENDING slots
+    std::size_t pending_ = 0;
+    uint64_t dropped_ = 0;
+};
+
+// ============================================================================
+// Channel Server
+// ============================================================================
+
+// Server end of one client's channel: consumer `consumer_id` on the request
+// ring, producer on the response ring.
+class ChannelServer {
+public:
+    ChannelServer(void* req_header, void* req_data,
+                  void* resp_header, void* resp_data, uint8_t consumer_id)
+        : requests_(req_header, req_data, consumer_id),
+          responses_(resp_header, resp_data) {
+        detail::channel_check(req_header, resp_header);
+        requests_.attach();
+    }
+
+    // Invoke fn(uint64_t correlation_id, const void* payload, uint32_t size)
+    // for up to max_events pending requests
+    template <typename F>
+    auto poll(F&& fn, uint64_t max_events = UINT64_MAX) -> uint64_t {
+        return requests_.poll([&](const void* slot) {
+            auto* hdr = static_cast<const channel_header*>(slot);
+            fn(hdr->correlation_id, static_cast<const char*>(slot) + CHANNEL_HEADER_SIZE, hdr->size);
+        }, max_events);
+    }
+
+    // Send the response for `correlation_id`; false if the response ring is full
+    auto reply(uint64_t correlation_id, const void* payload, uint32_t size) -> bool {
+        return detail::channel_write(responses_, correlation_id, payload, size);
+    }
+
+private:
+    RingConsumer requests_;
+    RingProducer responses_;
+};
+
+} // namespace hftshm
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include "ring.hpp"
+#include "copy.hpp"
+
+namespace hftshm {
+
+// ============================================================================
+// Column Specs
+// ============================================================================
+
+// One fixed-offset field to extract from each event into a contiguous array.
+// width must be 4 or 8 bytes; out must hold at least the batch size.
+struct ColumnSpec {
+    uint16_t offset;    // Field offset within the event
+    uint8_t  width;     // Field width in bytes (4 or 8)
+    void*    out;       // Caller-provided column array
+};
+
+// A spec is usable on a ring if its width is 4 or 8 and the field lies within event_size
+inline bool column_spec_validate(const metadata* meta, const ColumnSpec& col) {
+    return (col.width == 4 || col.width == 8) && uint32_t{col.offset} + col.width <= meta->event_size;
+}
+
+// ============================================================================
+// Strided Gather Kernels
+// ============================================================================
+
+namespace detail {
+
+// Gather `count` 4-byte fields spaced `stride` bytes apart starting at `src`
+inline void gather32_scalar(const char* src, uint32_t stride, std::size_t count, uint32_t* out) {
+    for (std::size_t i = 0; i < count; ++i, src += stride) {
+        std::memcpy(out + i, src, 4);
+    }
+}
+
+inline void gather64_scalar(const char* src, uint32_t stride, std::size_t count, uint64_t* out) {
+    for (std::size_t i = 0; i < count; ++i, src += stride) {
+        std::memcpy(out + i, src, 8);
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+__attribute__((target("avx2")))
+inline void gather32_avx2(const char* src, uint32_t stride, std::size_t count, uint32_t* out) {
+    const int s = static_cast<int>(stride);
+    const __m256i vindex = _mm256_setr_epi32(0, s, 2 * s, 3 * s, 4 * s, 5 * s, 6 * s, 7 * s);
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8, src += 8 * stride) {
+        __m256i v = _mm256_i32gather_epi32(reinterpret_cast<const int*>(src), vindex, 1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), v);
+    }
+    _mm256_zeroupper();
+    gather32_scalar(src, stride, count - i, out + i);
+}
+
+__attribute__((target("avx2")))
+inline void gather64_avx2(const char* src, uint32_t stride, std::size_t count, uint64_t* out) {
+    const int s = static_cast<int>(stride);
+    const __m128i vindex = _mm_setr_epi32(0, s, 2 * s, 3 * s);
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4, src += 4 * stride) {
+        __m256i v = _mm256_i32gather_epi64(reinterpret_cast<const long long*>(src), vindex, 1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), v);
+    }
+    _mm256_zeroupper();
+    gather64_scalar(src, stride, count - i, out + i);
+}
+
+#endif
+
+inline void gather32(const char* src, uint32_t stride, std::size_t count, uint32_t* out) {
+#if defined(__x86_64__) || defined(__i386__)
+    if (cpu_features().avx2) return gather32_avx2(src, stride, count, out);
+#endif
+    gather32_scalar(src, stride, count, out);
+}
+
+inline void gather64(const char* src, uint32_t stride, std::size_t count, uint64_t* out) {
+#if defined(__x86_64__) || defined(__i386__)
+    if (cpu_features().avx2) return gather64_avx2(src, stride, count, out);
+#endif
+    gather64_scalar(src, stride, count, out);
+}
+
+} // namespace detail
+
+// ============================================================================
+// Consumer Batch Decode
+// ============================================================================
+
+// Gather one field from events [first, first + count) into `out`.
+// The range is split at the end of the data segment so each run is a plain stride.
+inline void gather_column(const RingConsumer& consumer, uint64_t first, uint64_t count,
+                          const ColumnSpec& col) {
+    const metadata* meta = consumer.meta();
+    const uint32_t stride = slot_stride(meta);
+
+    auto* out = static_cast<char*>(col.out);
+    for_each_run(meta, first, count, [&](uint64_t seq, uint64_t run) {
+        const char* src = static_cast<const char*>(consumer.slot(seq)) + col.offset;
+        if (col.width == 8) {
+            detail::gather64(src, stride, run, reinterpret_cast<uint64_t*>(out));
+        } else {
+            detail::gather32(src, stride, run, reinterpret_cast<uint32_t*>(out));
+        }
+        out += run * col.width;
+    });
+}
+
+// Decode up to max_events available events into columnar arrays and advance.
+// Returns the number of rows written to every column. Specs must pass
+// column_spec_validate(); ColumnDecoder checks them once up front.
+inline auto read_columns(RingConsumer& consumer, const ColumnSpec* cols, std::size_t ncols,
+                         uint64_t max_events) -> uint64_t {
+    uint64_t n = std::min(consumer.available(), max_events);
+    if (n == 0) return 0;
+    for (std::size_t c = 0; c < ncols; ++c) {
+        gather_column(consumer, consumer.sequence(), n, cols[c]);
+    }
+    consumer.advance(n);
+    return n;
+}
+
+// ============================================================================
+// Column Decoder
+// ============================================================================
+
+// read_columns() over a fixed set of specs, validated at construction: throws
+// std::invalid_argument for a width other than 4 or 8 or a field past event_size.
+class ColumnDecoder {
+public:
+    ColumnDecoder(RingConsumer& consumer, const ColumnSpec* cols, std::size_t ncols)
+        : consumer_(consumer),
+          cols_(cols, cols + ncols) {
+        for (const ColumnSpec& col : cols_) {
+            if (!column_spec_validate(consumer.meta(), col)) {
+                throw std::invalid_argument("hftshm: column width must be 4 or 8 and lie within event_size");
+            }
+        }
+    }
+
+    // Decode up to max_events events (at most the column arrays' capacity)
+    auto read(uint64_t max_events) -> uint64_t {
+        return read_columns(consumer_, cols_.data(), cols_.size(), max_events);
+    }
+
+    auto consumer() -> RingConsumer& { return consumer_; }
+
+private:
+    RingConsumer& consumer_;
+    std::vector<ColumnSpec> cols_;
+};
+
+} // namespace hftshm
@@ -0,0 +1,290 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "offset_ptr.hpp"
+
+namespace hftshm {
+
+// Containers placed in a shared arena. All internal links are offset_ptrs,
+// so a container has the same layout and is usable in every process mapping
+// the segment. Elements must be trivially copyable. None of these containers
+// synchronizes: use a single writer, or guard them (e.g. with a seqlock).
+// Containers must live in the segment themselves and must not be copied.
+
+// ============================================================================
+// Hashing
+// ============================================================================
+
+// Process-independent hash (std::hash may differ between builds)
+template <typename K>
+struct shm_hash {
+    auto operator()(const K& key) const -> uint64_t {
+        if constexpr (std::is_integral_v<K> && sizeof(K) <= 8) {
+            uint64_t h = static_cast<uint64_t>(key);
+            h ^= h >> 33;
+            h *= 0xFF51AFD7ED558CCDULL;
+            h ^= h >> 33;
+            h *= 0xC4CEB9FE1A85EC53ULL;
+            h ^= h >> 33;
+            return h;
+        } else {
+            // FNV-1a over the key's bytes
+            const auto* p = reinterpret_cast<const unsigned char*>(&key);
+            uint64_t h = 0xCBF29CE484222325ULL;
+            for (std::size_t i = 0; i < sizeof(K); ++i) {
+                h = (h ^ p[i]) * 0x100000001B3ULL;
+            }
+            return h;
+        }
+    }
+};
+
+// ============================================================================
+// Vector
+// ============================================================================
+
+template <typename T>
+class shm_vector {
+    static_assert(std::is_trivially_copyable_v<T>, "Segment elements must be trivially copyable");
+
+public:
+    shm_vector(shm_arena* arena, std::size_t capacity)
+        : arena_(arena), data_(arena_alloc_array<T>(arena, capacity)),
+          size_(0), capacity_(data_ ? capacity : 0) {}
+
+    shm_vector(const shm_vector&) = delete;
+    auto operator=(const shm_vector&) -> shm_vector& = delete;
+
+    // Append; grows by doubling. Old storage is not returned to the arena.
+    auto push_back(const T& value) -> bool {
+        if (size_ == capacity_ && !reserve(capacity_ ? capacity_ * 2 : 8)) return false;
+        data_[size_++] = value;
+        return true;
+    }
+
+    auto reserve(std::size_t capacity) -> bool {
+        if (capacity <= capacity_) return true;
+        T* grown = arena_alloc_array<T>(arena_.get(), capacity);
+        if (!grown) return false;
+        if (size_) std::memcpy(grown, data_.get(), size_ * sizeof(T));
+        data_ = grown;
+        capacity_ = capacity;
+        return true;
+    }
+
+    auto pop_back() -> void { --size_; }
+    auto clear() -> void { size_ = 0; }
+
+    auto operator[](std::size_t i) -> T& { return data_[i]; }
+    auto operator[](std::size_t i) const -> const T& { return data_[i]; }
+    auto back() -> T& { return data_[size_ - 1]; }
+
+    auto begin() -> T* { return data_.get(); }
+    auto end() -> T* { return data_.get() + size_; }
+    auto begin() const -> const T* { return data_.get(); }
+    auto end() const -> const T* { return data_.get() + size_; }
+
+    auto size() const -> std::size_t { return size_; }
+    auto capacity() const -> std::size_t { return capacity_; }
+    auto empty() const -> bool { return size_ == 0; }
+
+private:
+    offset_ptr<shm_arena> arena_;
+    offset_ptr<T> data_;
+    uint64_t size_;
+    uint64_t capacity_;
+};
+
+// ============================================================================
+// Open-Addressing Hash Map
+// ============================================================================
+
+// Fixed-capacity linear-probing map (capacity rounded up to a power of 2).
+// Deletion uses backward shift, so lookups never walk tombstones.
+template <typename K, typename V, typename Hash = shm_hash<K>>
+class shm_hash_map {
+    static_assert(std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>,
+                  "Segment keys and values must be trivially copyable");
+
+public:
+    struct entry {
+        K key;
+        V value;
+        bool used;
+    };
+
+    shm_hash_map(shm_arena* arena, std::size_t capacity)
+        : mask_(0), size_(0) {
+        std::size_t cap = 8;
+        while (cap < capacity) cap <<= 1;
+        entry* e = arena_alloc_array<entry>(arena, cap);
+        if (e) {
+            std::memset(static_cast<void*>(e), 0, cap * sizeof(entry));
+            mask_ = cap - 1;
+        }
+        entries_ = e;
+    }
+
+    shm_hash_map(const shm_hash_map&) = delete;
+    auto operator=(const shm_hash_map&) -> shm_hash_map& = delete;
+
+    auto find(const K& key) -> V* {
+        if (!entries_) return nullptr;
+        entry* e = entries_.get();
+        for (uint64_t i = Hash{}(key) & mask_;; i = (i + 1) & mask_) {
+            if (!e[i].used) return nullptr;
+            if (std::memcmp(&e[i].key, &key, sizeof(K)) == 0) return &e[i].value;
+        }
+    }
+
+    auto find(const K& key) const -> const V* {
+        return const_cast<shm_hash_map*>(this)->find(key);
+    }
+
+    // Insert or overwrite; false when full (load kept below 100%)
+    auto insert(const K& key, const V& value) -> bool {
+        if (!entries_) return false;
+        entry* e = entries_.get();
+        for (uint64_t i = Hash{}(key) & mask_;; i = (i + 1) & mask_) {
+            if (!e[i].used) {
+                if (size_ == mask_) return false;
+                e[i].key = key;
+                e[i].value = value;
+                e[i].used = true;
+                ++size_;
+                return true;
+            }
+            if (std::memcmp(&e[i].key, &key, sizeof(K)) == 0) {
+                e[i].value = value;
+                return true;
+            }
+        }
+    }
+
+    auto erase(const K& key) -> bool {
+        if (!entries_) return false;
+        entry* e = entries_.get();
+        uint64_t i = Hash{}(key) & mask_;
+        for (;; i = (i + 1) & mask_) {
+            if (!e[i].used) return false;
+            if (std::memcmp(&e[i].key, &key, sizeof(K)) == 0) break;
+        }
+        // Backward shift: pull later entries of the probe run into the hole
+        for (uint64_t j = (i + 1) & mask_; e[j].used; j = (j + 1) & mask_) {
+            uint64_t home = Hash{}(e[j].key) & mask_;
+            if (((j - home) & mask_) >= ((j - i) & mask_)) {
+                e[i] = e[j];
+                i = j;
+            }
+        }
+        e[i].used = false;
+        --size_;
+        return true;
+    }
+
+    // Invoke fn(const K&, V&) for every entry
+    template <typename F>
+    auto for_each(F&& fn) -> void {
+        if (!entries_) return;
+        entry* e = entries_.get();
+        for (uint64_t i = 0; i <= mask_; ++i) {
+            if (e[i].used) fn(e[i].key, e[i].value);
+        }
+    }
+
+    auto size() const -> std::size_t { return size_; }
+    auto capacity() const -> std::size_t { return entries_ ? mask_ + 1 : 0; }
+
+private:
+    offset_ptr<entry> entries_;
+    uint64_t mask_;
+    uint64_t size_;
+};
+
+// ============================================================================
+// Intrusive List
+// ============================================================================
+
+// Embed in T and pass offsetof(T, hook) to shm_list
+struct shm_list_hook {
+    offset_ptr<shm_list_hook> prev;
+    offset_ptr<shm_list_hook> next;
+
+    auto linked() const -> bool { return static_cast<bool>(next); }
+};
+
+// Doubly linked list over objects already allocated in the segment
+template <typename T, std::size_t HookOffset>
+class shm_list {
+public:
+    class iterator {
+    public:
+        explicit iterator(shm_list_hook* h) : h_(h) {}
+        auto operator*() const -> T& { return *from_hook(h_); }
+        auto operator->() const -> T* { return from_hook(h_); }
+        auto operator++() -> iterator& {
+            h_ = h_->next.get();
+            return *this;
+        }
+        auto operator!=(const iterator& o) const -> bool { return h_ != o.h_; }
+        auto operator==(const iterator& o) const -> bool { return h_ == o.h_; }
+
+    private:
+        shm_list_hook* h_;
+    };
+
+    shm_list() : size_(0) {
+        head_.prev = &head_;
+        head_.next = &head_;
+    }
+
+    shm_list(const shm_list&) = delete;
+    auto operator=(const shm_list&) -> shm_list& = delete;
+
+    auto push_back(T& item) -> void { link_before(&head_, hook(item)); }
+    auto push_front(T& item) -> void { link_before(head_.next.get(), hook(item)); }
+
+    auto erase(T& item) -> void {
+        shm_list_hook* h = hook(item);
+        h->prev->next = h->next;
+        h->next->prev = h->prev;
+        h->prev = nullptr;
+        h->next = nullptr;
+        --size_;
+    }
+
+    auto front() -> T& { return *from_hook(head_.next.get()); }
+    auto back() -> T& { return *from_hook(head_.prev.get()); }
+
+    auto begin() -> iterator { return iterator(head_.next.get()); }
+    auto end() -> iterator { return iterator(&head_); }
+
+    auto size() const -> std::size_t { return size_; }
+    auto empty() const -> bool { return size_ == 0; }
+
+private:
+    static auto hook(T& item) -> shm_list_hook* {
+        return reinterpret_cast<shm_list_hook*>(reinterpret_cast<char*>(&item) + HookOffset);
+    }
+
+    static auto from_hook(shm_list_hook* h) -> T* {
+        return reinterpret_cast<T*>(reinterpret_cast<char*>(h) - HookOffset);
+    }
+
+    auto link_before(shm_list_hook* pos, shm_list_hook* h) -> void {
+        h->next = pos;
+        h->prev = pos->prev;
+        pos->prev->next = h;
+        pos->prev = h;
+        ++size_;
+    }
+
+    shm_list_hook head_;    // Sentinel; the list is circular through it
+    uint64_t size_;
+};
+
+} // namespace hftshm
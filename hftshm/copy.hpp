@@ -0,0 +1,228 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#include <cpuid.h>
+#endif
+
+namespace hftshm {
+
+// ============================================================================
+// CPU Features
+// ============================================================================
+
+struct CpuFeatures {
+    bool sse2 = false;
+    bool avx2 = false;
+    bool avx512f = false;
+    bool erms = false;      // Enhanced REP MOVSB
+};
+
+// Detected once per process via CPUID
+inline auto cpu_features() -> const CpuFeatures& {
+    static const CpuFeatures features = [] {
+        CpuFeatures f;
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_cpu_init();
+        f.sse2 = __builtin_cpu_supports("sse2");
+        f.avx2 = __builtin_cpu_supports("avx2");
+        f.avx512f = __builtin_cpu_supports("avx512f");
+        unsigned eax, ebx, ecx, edx;
+        if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+            f.erms = (ebx & (1u << 9)) != 0;
+        }
+#endif
+        return f;
+    }();
+    return features;
+}
+
+// ============================================================================
+// Non-Temporal Copy
+// ============================================================================
+
+// Events smaller than this are copied normally even on NT rings;
+// streaming a single line costs more than the cache pollution it avoids
+inline constexpr std::size_t NT_COPY_MIN_SIZE = 256;
+
+// Copy `size` bytes with non-temporal stores that bypass the writer's caches.
+// Falls back to memcpy when dst is not 16-byte aligned or on non-x86 targets.
+// Must be followed by store_fence() before the data is published.
+inline void copy_stream(void* dst, const void* src, std::size_t size) {
+#if defined(__SSE2__)
+    if ((reinterpret_cast<uintptr_t>(dst) & 15) != 0) {
+        std::memcpy(dst, src, size);
+        return;
+    }
+    auto* d = static_cast<__m128i*>(dst);
+    auto* s = static_cast<const __m128i*>(src);
+    std::size_t blocks = size / 64;
+    for (std::size_t i = 0; i < blocks; ++i, d += 4, s += 4) {
+        __m128i a = _mm_loadu_si128(s + 0);
+        __m128i b = _mm_loadu_si128(s + 1);
+        __m128i c = _mm_loadu_si128(s + 2);
+        __m128i e = _mm_loadu_si128(s + 3);
+        _mm_stream_si128(d + 0, a);
+        _mm_stream_si128(d + 1, b);
+        _mm_stream_si128(d + 2, c);
+        _mm_stream_si128(d + 3, e);
+    }
+    for (std::size_t i = 0; i < (size % 64) / 16; ++i, ++d, ++s) {
+        _mm_stream_si128(d, _mm_loadu_si128(s));
+    }
+    if (size % 16) {
+        std::memcpy(d, s, size % 16);
+    }
+#else
+    std::memcpy(dst, src, size);
+#endif
+}
+
+// Order preceding non-temporal stores before the publishing cursor store
+inline void store_fence() {
+#if defined(__SSE2__)
+    _mm_sfence();
+#else
+    std::atomic_thread_fence(std::memory_order_release);
+#endif
+}
+
+// ============================================================================
+// Size-Specialized Event Copy
+// ============================================================================
+
+// Events up to this size are copied with compile-time-sized moves
+inline constexpr std::size_t COPY_INLINE_MAX_SIZE = 64;
+
+// Events of at least this size use REP MOVSB when the CPU has ERMS
+inline constexpr std::size_t REP_MOVSB_MIN_SIZE = 2048;
+
+// Copy kernel signature; size is a power of 2 above COPY_INLINE_MAX_SIZE
+using copy_fn = void (*)(void* dst, const void* src, std::size_t size);
+
+namespace detail {
+
+#if defined(__x86_64__) || defined(__i386__)
+
+inline void copy_sse2(void* dst, const void* src, std::size_t size) {
+    auto* d = static_cast<__m128i*>(dst);
+    auto* s = static_cast<const __m128i*>(src);
+    for (std::size_t i = 0; i < size / 16; i += 8) {
+        __m128i r0 = _mm_loadu_si128(s + i + 0);
+        __m128i r1 = _mm_loadu_si128(s + i + 1);
+        __m128i r2 = _mm_loadu_si128(s + i + 2);
+        __m128i r3 = _mm_loadu_si128(s + i + 3);
+        __m128i r4 = _mm_loadu_si128(s + i + 4);
+        __m128i r5 = _mm_loadu_si128(s + i + 5);
+        __m128i r6 = _mm_loadu_si128(s + i + 6);
+        __m128i r7 = _mm_loadu_si128(s + i + 7);
+        _mm_storeu_si128(d + i + 0, r0);
+        _mm_storeu_si128(d + i + 1, r1);
+        _mm_storeu_si128(d + i + 2, r2);
+        _mm_storeu_si128(d + i + 3, r3);
+        _mm_storeu_si128(d + i + 4, r4);
+        _mm_storeu_si128(d + i + 5, r5);
+        _mm_storeu_si128(d + i + 6, r6);
+        _mm_storeu_si128(d + i + 7, r7);
+    }
+}
+
+__attribute__((target("avx2")))
+inline void copy_avx2(void* dst, const void* src, std::size_t size) {
+    auto* d = static_cast<__m256i*>(dst);
+    auto* s = static_cast<const __m256i*>(src);
+    for (std::size_t i = 0; i < size / 32; i += 4) {
+        __m256i r0 = _mm256_loadu_si256(s + i + 0);
+        __m256i r1 = _mm256_loadu_si256(s + i + 1);
+        __m256i r2 = _mm256_loadu_si256(s + i + 2);
+        __m256i r3 = _mm256_loadu_si256(s + i + 3);
+        _mm256_storeu_si256(d + i + 0, r0);
+        _mm256_storeu_si256(d + i + 1, r1);
+        _mm256_storeu_si256(d + i + 2, r2);
+        _mm256_storeu_si256(d + i + 3, r3);
+    }
+    _mm256_zeroupper();
+}
+
+__attribute__((target("avx512f")))
+inline void copy_avx512(void* dst, const void* src, std::size_t size) {
+    auto* d = static_cast<char*>(dst);
+    auto* s = static_cast<const char*>(src);
+    for (std::size_t i = 0; i < size; i += 128) {
+        __m512i r0 = _mm512_loadu_si512(s + i);
+        __m512i r1 = _mm512_loadu_si512(s + i + 64);
+        _mm512_storeu_si512(d + i, r0);
+        _mm512_storeu_si512(d + i + 64, r1);
+    }
+    _mm256_zeroupper();
+}
+
+#if defined(__x86_64__)
+inline void copy_rep_movsb(void* dst, const void* src, std::size_t size) {
+    asm volatile("rep movsb" : "+D"(dst), "+S"(src), "+c"(size) : : "memory");
+}
+#endif
+
+#endif
+
+// Pick the best kernel for a copy of `size` bytes on this CPU
+inline auto select_copy_kernel(std::size_t size) -> copy_fn {
+#if defined(__x86_64__)
+    const auto& f = cpu_features();
+    if (f.erms && size >= REP_MOVSB_MIN_SIZE) return copy_rep_movsb;
+    if (f.avx512f) return copy_avx512;
+    if (f.avx2) return copy_avx2;
+    return copy_sse2;
+#else
+    (void)size;
+    return [](void* dst, const void* src, std::size_t n) { std::memcpy(dst, src, n); };
+#endif
+}
+
+} // namespace detail
+
+// Copy one event of (1 << Log2) bytes.
+// Small events compile to straight-line moves; larger events go through the
+// kernel selected once per size class from CPUID.
+template <uint8_t Log2>
+inline void copy_event(void* dst, const void* src) {
+    constexpr std::size_t size = std::size_t{1} << Log2;
+    if constexpr (size <= COPY_INLINE_MAX_SIZE) {
+        std::memcpy(dst, src, size);
+    } else {
+        static const copy_fn kernel = detail::select_copy_kernel(size);
+        kernel(dst, src, size);
+    }
+}
+
+// Event copy for a ring's event_size_log2 known only at runtime
+using event_copy_fn = void (*)(void* dst, const void* src);
+
+inline auto event_copy_kernel(uint8_t event_size_log2) -> event_copy_fn {
+    switch (event_size_log2) {
+        case 0:  return copy_event<0>;
+        case 1:  return copy_event<1>;
+        case 2:  return copy_event<2>;
+        case 3:  return copy_event<3>;
+        case 4:  return copy_event<4>;
+        case 5:  return copy_event<5>;
+        case 6:  return copy_event<6>;
+        case 7:  return copy_event<7>;
+        case 8:  return copy_event<8>;
+        case 9:  return copy_event<9>;
+        case 10: return copy_event<10>;
+        case 11: return copy_event<11>;
+        case 12: return copy_event<12>;
+        case 13: return copy_event<13>;
+        case 14: return copy_event<14>;
+        case 15: return copy_event<15>;
+        default: return nullptr;  // event_size is a uint16_t
+    }
+}
+
+} // namespace hftshm
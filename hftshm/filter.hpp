@@ -0,0 +1,167 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+
+#include "ring.hpp"
+#include "copy.hpp"
+
+namespace hftshm {
+
+// ============================================================================
+// Key Filter
+// ============================================================================
+
+// Predicate on a 32-bit key at a fixed offset in every event:
+// either membership in a small key set or an inclusive [lo, hi] range.
+struct KeyFilter {
+    static constexpr std::size_t MAX_KEYS = 16;
+
+    uint16_t key_offset = 0;
+    uint8_t  nkeys = 0;
+    bool     range = false;
+    uint32_t lo = 0;
+    uint32_t hi = 0;
+    uint32_t keys[MAX_KEYS] = {};
+
+    // Match any of up to MAX_KEYS keys (extra keys are ignored)
+    static auto any_of(uint16_t offset, std::initializer_list<uint32_t> list) -> KeyFilter {
+        KeyFilter f;
+        f.key_offset = offset;
+        for (uint32_t k : list) {
+            if (f.nkeys == MAX_KEYS) break;
+            f.keys[f.nkeys++] = k;
+        }
+        return f;
+    }
+
+    // Match lo <= key <= hi
+    static auto between(uint16_t offset, uint32_t lo, uint32_t hi) -> KeyFilter {
+        KeyFilter f;
+        f.key_offset = offset;
+        f.range = true;
+        f.lo = lo;
+        f.hi = hi;
+        return f;
+    }
+
+    auto matches(uint32_t key) const -> bool {
+        if (range) return key - lo <= hi - lo;
+        for (uint8_t i = 0; i < nkeys; ++i) {
+            if (keys[i] == key) return true;
+        }
+        return false;
+    }
+};
+
+// ============================================================================
+// Filter Kernels
+// ============================================================================
+
+namespace detail {
+
+// Scan `count` events starting at `src` (key field address of the first event),
+// spaced `stride` bytes apart; write matching sequences (first + i) to out.
+inline auto filter_scalar(const char* src, uint32_t stride, std::size_t count, uint64_t first,
+                          const KeyFilter& f, uint64_t* out) -> std::size_t {
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < count; ++i, src += stride) {
+        uint32_t key;
+        std::memcpy(&key, src, 4);
+        if (f.matches(key)) out[n++] = first + i;
+    }
+    return n;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+__attribute__((target("avx2")))
+inline auto filter_avx2(const char* src, uint32_t stride, std::size_t count, uint64_t first,
+                        const KeyFilter& f, uint64_t* out) -> std::size_t {
+    const int s = static_cast<int>(stride);
+    const __m256i vindex = _mm256_setr_epi32(0, s, 2 * s, 3 * s, 4 * s, 5 * s, 6 * s, 7 * s);
+    const __m256i sign = _mm256_set1_epi32(static_cast<int>(0x80000000u));
+    const __m256i lo = _mm256_set1_epi32(static_cast<int>(f.lo));
+    const __m256i span = _mm256_xor_si256(_mm256_set1_epi32(static_cast<int>(f.hi - f.lo)), sign);
+
+    std::size_t n = 0;
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8, src += 8 * stride) {
+        __m256i k = _mm256_i32gather_epi32(reinterpret_cast<const int*>(src), vindex, 1);
+        __m256i hit;
+        if (f.range) {
+            // (key - lo) <=u (hi - lo), via signed compare on sign-flipped values
+            __m256i d = _mm256_xor_si256(_mm256_sub_epi32(k, lo), sign);
+            hit = _mm256_andnot_si256(_mm256_cmpgt_epi32(d, span), _mm256_set1_epi32(-1));
+        } else {
+            hit = _mm256_setzero_si256();
+            for (uint8_t j = 0; j < f.nkeys; ++j) {
+                hit = _mm256_or_si256(hit, _mm256_cmpeq_epi32(k, _mm256_set1_epi32(static_cast<int>(f.keys[j]))));
+            }
+        }
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(hit)));
+        while (mask) {
+            out[n++] = first + i + static_cast<uint64_t>(__builtin_ctz(mask));
+            mask &= mask - 1;
+        }
+    }
+    _mm256_zeroupper();
+    return n + filter_scalar(src, stride, count - i, first + i, f, out + n);
+}
+
+#endif
+
+inline auto filter_run(const char* src, uint32_t stride, std::size_t count, uint64_t first,
+                       const KeyFilter& f, uint64_t* out) -> std::size_t {
+#if defined(__x86_64__) || defined(__i386__)
+    if (cpu_features().avx2) return filter_avx2(src, stride, count, first, f, out);
+#endif
+    return filter_scalar(src, stride, count, first, f, out);
+}
+
+} // namespace detail
+
+// ============================================================================
+// Consumer Filter API
+// ============================================================================
+
+// Evaluate `f` on events [first, first + count); write matching sequences to out
+// (capacity >= count). Returns the number of matches.
+inline auto filter_sequences(const RingConsumer& consumer, uint64_t first, uint64_t count,
+                             const KeyFilter& f, uint64_t* out) -> std::size_t {
+    const metadata* meta = consumer.meta();
+    const uint32_t stride = slot_stride(meta);
+
+    std::size_t n = 0;
+    for_each_run(meta, first, count, [&](uint64_t seq, uint64_t run) {
+        const char* src = static_cast<const char*>(consumer.slot(seq)) + f.key_offset;
+        n += detail::filter_run(src, stride, run, seq, f, out + n);
+    });
+    return n;
+}
+
+// Scan up to max_events available events and invoke fn(const void* event) only
+// for matches; the cursor advances past every scanned event.
+template <typename F>
+inline auto poll_filtered(RingConsumer& consumer, const KeyFilter& f, F&& fn,
+                          uint64_t max_events = UINT64_MAX) -> uint64_t {
+    constexpr uint64_t CHUNK = 256;
+    uint64_t matches[CHUNK];
+
+    uint64_t n = std::min(consumer.available(), max_events);
+    uint64_t first = consumer.sequence();
+    for (uint64_t done = 0; done < n; done += CHUNK) {
+        uint64_t run = std::min(CHUNK, n - done);
+        std::size_t hits = filter_sequences(consumer, first + done, run, f, matches);
+        for (std::size_t i = 0; i < hits; ++i) {
+            fn(consumer.slot(matches[i]));
+        }
+    }
+    if (n) consumer.advance(n);
+    return n;
+}
+
+} // namespace hftshm
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include "ring.hpp"
+
+namespace hftshm {
+
+// ============================================================================
+// Message Framing
+// ============================================================================
+
+// A message occupies ceil((FRAME_HEADER_SIZE + length) / slot_stride) consecutive
+// slots and is written as one contiguous byte run: the frame header, then the
+// payload straight across slot boundaries. Slots are published together, so a
+// consumer never sees a partial message. A message that fits one slot costs
+// one slot and is read in place like any other event.
+//
+// Requires event_size >= FRAME_HEADER_SIZE (the writer and reader throw
+// std::invalid_argument otherwise); the largest message is
+// buffer_size - FRAME_HEADER_SIZE bytes.
+struct frame_header {
+    uint32_t length;                  // 0x00: Payload bytes
+    uint32_t slots;                   // 0x04: Slots used by this message
+};
+inline constexpr uint32_t FRAME_HEADER_SIZE = sizeof(frame_header);
+
+// Slots needed for a message of `length` bytes
+inline uint32_t frame_slots(const metadata* meta, uint32_t length) {
+    uint64_t bytes = uint64_t{FRAME_HEADER_SIZE} + length;
+    return static_cast<uint32_t>((bytes + slot_stride(meta) - 1) >> meta->event_size_log2);
+}
+
+// Framed rings need room for the frame header in every slot
+inline bool fragment_validate(const void* header) {
+    return metadata_get(header)->event_size >= FRAME_HEADER_SIZE;
+}
+
+namespace detail {
+
+inline auto fragment_check(const void* header) -> void {
+    if (!fragment_validate(header)) {
+        throw std::invalid_argument("hftshm: framed rings need event_size >= FRAME_HEADER_SIZE");
+    }
+}
+
+} // namespace detail
+
+// ============================================================================
+// Fragmenting Writer
+// ============================================================================
+
+class FragmentWriter {
+public:
+    FragmentWriter(void* header, void* data)
+        : ring_(header, data) {
+        detail::fragment_check(header);
+    }
+
+    // Write one message of any size up to buffer_size - FRAME_HEADER_SIZE.
+    // Returns false if the ring lacks room (retry later) or the message can never fit.
+    auto try_write(const void* message, uint32_t length) -> bool {
+        const metadata* meta = ring_.meta();
+        if (uint64_t{length} + FRAME_HEADER_SIZE > meta->buffer_size) return false;
+
+        uint32_t slots = frame_slots(meta, length);
+        char* first = static_cast<char*>(ring_.try_claim(slots));
+        if (!first) return false;
+
+        frame_header hdr{length, slots};
+        std::memcpy(first, &hdr, FRAME_HEADER_SIZE);
+
+        // Payload runs to the end of the data segment, then wraps to its start
+        char* end = ring_.data() + meta->buffer_size;
+        char* dst = first + FRAME_HEADER_SIZE;
+        std::size_t head = std::min<std::size_t>(length, static_cast<std::size_t>(end - dst));
+        std::memcpy(dst, message, head);
+        std::memcpy(ring_.data(), static_cast<const char*>(message) + head, length - head);
+
+        ring_.publish(slots);
+        return true;
+    }
+
+    auto ring() -> RingProducer& { return ring_; }
+
+private:
+    RingProducer ring_;
+};
+
+// ============================================================================
+// Reassembling Reader
+// ============================================================================
+
+class FragmentReader {
+public:
+    FragmentReader(void* header, void* data, uint8_t id)
+        : ring_(header, data, id) {
+        detail::fragment_check(header);
+    }
+
+    auto attach() -> void { ring_.attach(); }
+    auto detach() -> void { ring_.detach(); }
+
+    // Invoke fn(const void* message, uint32_t length) for up to max_messages
+    // messages. The view points into the ring when the message is contiguous and
+    // into a reassembly buffer when it wraps; it is valid only during the call.
+    template <typename F>
+    auto poll(F&& fn, uint64_t max_messages = UINT64_MAX) -> uint64_t {
+        const metadata* meta = ring_.meta();
+        uint64_t n = 0;
+        while (n < max_messages && ring_.available() > 0) {
+            auto* first = static_cast<const char*>(ring_.slot(ring_.sequence()));
+            frame_header hdr;
+            std::memcpy(&hdr, first, FRAME_HEADER_SIZE);
+
+            const char* payload = first + FRAME_HEADER_SIZE;
+            const char* end = ring_.data() + meta->buffer_size;
+            if (payload + hdr.length > end) {
+                std::size_t head = static_cast<std::size_t>(end - payload);
+                reassembly_.resize(hdr.length);
+                std::memcpy(reassembly_.data(), payload, head);
+                std::memcpy(reassembly_.data() + head, ring_.data(), hdr.length - head);
+                payload = reassembly_.data();
+            }
+            fn(static_cast<const void*>(payload), hdr.length);
+            ring_.advance(hdr.slots);
+            ++n;
+        }
+        return n;
+    }
+
+    auto ring() -> RingConsumer& { return ring_; }
+
+private:
+    RingConsumer ring_;
+    std::vector<char> reassembly_;    // Copy target for wrapped messages
+};
+
+} // namespace hftshm
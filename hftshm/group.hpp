@@ -0,0 +1,129 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include <unistd.h>
+
+#include "ring.hpp"
+#include "wait.hpp"
+
+namespace hftshm {
+
+// ============================================================================
+// Consumer Group
+// ============================================================================
+
+// Default events claimed per batch
+inline constexpr uint32_t GROUP_DEFAULT_BATCH = 16;
+
+// consumer_section::workers bit held by the last worker while it detaches
+inline constexpr uint32_t GROUP_WORKERS_CLOSING = 0x80000000u;
+
+// One worker of a work-distributing consumer group. All workers share one
+// consumer section: they claim disjoint batches of sequences from its `claim`
+// counter (work-queue semantics, each event goes to exactly one worker) and
+// commit in claim order, so the section's cursor only moves past a batch once
+// every earlier batch is done. The producer and any downstream stages gate
+// on that cursor exactly as on a single consumer.
+//
+// A worker that dies between claim and commit stalls the group; detach the
+// section and re-attach the group to recover. Use one GroupWorker per thread.
+class GroupWorker {
+public:
+    GroupWorker(void* header, void* data, uint8_t group_id, uint32_t batch = GROUP_DEFAULT_BATCH)
+        : header_(header),
+          meta_(metadata_get(header)),
+          cons_(consumer_get(header, group_id)),
+          data_(static_cast<const char*>(data)),
+          batch_(std::max<uint32_t>(batch, 1)) {}
+
+    // Join the group. The first worker starts it at the current barrier and
+    // then sets CONSUMER_FLAG_GROUP; later workers join only once that flag
+    // is set, and wait while the last worker is still leaving.
+    auto attach() -> void {
+        for (;;) {
+            uint32_t w = cons_->workers.load(std::memory_order_acquire);
+            if (w == 0) {
+                if (cons_->workers.compare_exchange_weak(w, 1, std::memory_order_acq_rel)) {
+                    start();
+                    return;
+                }
+            } else if (!(w & GROUP_WORKERS_CLOSING) &&
+                       (cons_->flags.load(std::memory_order_acquire) & CONSUMER_FLAG_GROUP)) {
+                if (cons_->workers.compare_exchange_weak(w, w + 1, std::memory_order_acq_rel)) return;
+            }
+            cpu_relax();
+        }
+    }
+
+    // Leave the group; the last worker clears CONSUMER_FLAG_GROUP and stops
+    // gating the producer
+    auto detach() -> void {
+        uint32_t w = cons_->workers.load(std::memory_order_relaxed);
+        for (;;) {
+            if (w == 1) {
+                if (!cons_->workers.compare_exchange_weak(w, GROUP_WORKERS_CLOSING, std::memory_order_acq_rel)) continue;
+                cons_->flags.fetch_and(~CONSUMER_FLAG_GROUP, std::memory_order_release);
+                cons_->pid.store(0, std::memory_order_release);
+                cons_->workers.store(0, std::memory_order_release);
+                return;
+            }
+            if (cons_->workers.compare_exchange_weak(w, w - 1, std::memory_order_acq_rel)) return;
+        }
+    }
+
+    // Claim up to one batch, invoke fn(const void* event, uint64_t sequence)
+    // for each event, then commit once every earlier batch has committed.
+    // Returns the number of events processed (0 if nothing was available).
+    template <typename F, typename Wait = BusySpinWait>
+    auto poll(F&& fn, const Wait& wait = Wait{}) -> uint64_t {
+        uint64_t start = cons_->claim.load(std::memory_order_relaxed);
+        uint64_t n;
+        do {
+            uint64_t upper = read_barrier(header_, depends());
+            if (start >= upper) return 0;
+            n = std::min<uint64_t>(batch_, upper - start);
+        } while (!cons_->claim.compare_exchange_weak(start, start + n, std::memory_order_acquire,
+                                                     std::memory_order_relaxed));
+
+        for (uint64_t seq = start; seq < start + n; ++seq) {
+            fn(static_cast<const void*>(data_ + slot_offset(meta_, seq)), seq);
+        }
+
+        // Ordered commit: wait for the group cursor to reach our batch
+        for (uint32_t attempt = 0; cons_->cursor.load(std::memory_order_acquire) != start; ++attempt) {
+            wait.idle(attempt);
+        }
+        cons_->cursor.store(start + n, std::memory_order_release);
+        return n;
+    }
+
+    // Committed position of the whole group
+    auto cursor() const -> uint64_t { return cons_->cursor.load(std::memory_order_acquire); }
+
+private:
+    auto depends() const -> uint64_t { return cons_->depends.load(std::memory_order_relaxed); }
+
+    // First worker: position the group at the barrier, register, then mark it ready
+    auto start() -> void {
+        uint64_t seq = read_barrier(header_, depends());
+        cons_->claim.store(seq, std::memory_order_relaxed);
+        cons_->cursor.store(seq, std::memory_order_seq_cst);
+        cons_->pid.store(static_cast<uint32_t>(::getpid()), std::memory_order_seq_cst);
+        // Re-sync in case the producer published while we registered
+        seq = read_barrier(header_, depends());
+        cons_->claim.store(seq, std::memory_order_relaxed);
+        cons_->cursor.store(seq, std::memory_order_relaxed);
+        cons_->flags.fetch_or(CONSUMER_FLAG_GROUP, std::memory_order_release);
+    }
+
+    void* header_;
+    const metadata* meta_;
+    consumer_section* cons_;
+    const char* data_;
+    uint32_t batch_;
+};
+
+} // namespace hftshm
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+namespace hftshm {
+
+// ============================================================================
+// Key Hashing
+// ============================================================================
+
+// 32-bit finalizer (murmur3 fmix32): spreads sequential instrument ids
+inline constexpr uint32_t key_hash(uint32_t key) {
+    key ^= key >> 16;
+    key *= 0x85EBCA6Bu;
+    key ^= key >> 13;
+    key *= 0xC2B2AE35u;
+    key ^= key >> 16;
+    return key;
+}
+
+} // namespace hftshm
@@ -52,6 +52,26 @@ inline std::string get_data_path(std::string_view name) {
     return std::string(BASE_PATH) + "/" + std::string(name) + ".dat";
 }
 
+// Get route file path: <base>/<name>.rt
+inline std::string get_route_path(std::string_view name) {
+    return std::string(BASE_PATH) + "/" + std::string(name) + ".rt";
+}
+
+// Get blob pool file path: <base>/<name>.blob
+inline std::string get_blob_path(std::string_view name) {
+    return std::string(BASE_PATH) + "/" + std::string(name) + ".blob";
+}
+
+// Get last-value cache file path: <base>/<name>.lvc
+inline std::string get_lvc_path(std::string_view name) {
+    return std::string(BASE_PATH) + "/" + std::string(name) + ".lvc";
+}
+
+// Get order book file path: <base>/<name>.book
+inline std::string get_book_path(std::string_view name) {
+    return std::string(BASE_PATH) + "/" + std::string(name) + ".book";
+}
+
 // ============================================================================
 // Magic Number and Version
 // ============================================================================
@@ -83,12 +103,21 @@ inline constexpr bool is_power_of_2(uint32_t x) {
     return x && !(x & (x - 1));
 }
 
+// Round up to a power of 2 (x must be in [1, 2^31])
+inline constexpr uint32_t next_power_of_2(uint32_t x) {
+    return x <= 1 ? 1 : 1u << (32 - __builtin_clz(x - 1));
+}
+
 // ============================================================================
 // Metadata Structure (Header File Layout)
 // ============================================================================
 
-// Fixed fields size (before padding) = 39 bytes
-inline constexpr std::size_t METADATA_FIXED_SIZE = 39;
+// Fixed fields size (before padding) = 48 bytes
+inline constexpr std::size_t METADATA_FIXED_SIZE = 48;
+
+// Metadata flags (per-ring options, 0 = defaults)
+inline constexpr uint8_t METADATA_FLAG_NT_STORES = 0x01;  // Producer writes slots with non-temporal stores
+inline constexpr uint8_t METADATA_FLAG_MULTI_PRODUCER = 0x02;  // Producers claim slots via a shared cursor
 
 // Metadata section (cache-line aligned)
 // SPMC only: single producer, multiple consumers
@@ -111,6 +140,8 @@ struct alignas(CACHE_LINE) metadata {
     uint8_t  event_size_log2;     // 0x24: log2(event_size) for shift ops
     uint8_t  buffer_size_log2;    // 0x25: log2(buffer_size) for shift ops
     uint8_t  header_size_log2;    // 0x26: log2(header_size) for shift ops
+    uint8_t  flags;               // 0x27: METADATA_FLAG_* options
+    uint64_t data_address;        // 0x28: Fixed data segment address (0 = map anywhere)
     uint8_t  padding[CACHE_LINE - METADATA_FIXED_SIZE];
 };
 static_assert(sizeof(metadata) == CACHE_LINE);
@@ -134,6 +165,21 @@ inline uint32_t buffer_index(const metadata* meta, uint64_t sequence) {
     return static_cast<uint32_t>(sequence) & meta->index_mask;
 }
 
+// Distance between consecutive slots: event_size rounded up to a power of 2
+inline uint32_t slot_stride(const metadata* meta) {
+    return 1u << meta->event_size_log2;
+}
+
+// Number of fixed-size event slots in the data segment
+inline uint32_t slot_count(const metadata* meta) {
+    return meta->buffer_size >> meta->event_size_log2;
+}
+
+// Fast sequence-to-offset: (sequence * event_size) & mask, wraps at buffer_size
+inline uint32_t slot_offset(const metadata* meta, uint64_t sequence) {
+    return (static_cast<uint32_t>(sequence) << meta->event_size_log2) & meta->index_mask;
+}
+
 // Validation: verify buffer_size is power of 2 and index_mask matches
 inline bool validate_sizes(const metadata* meta) {
     bool buffer_ok = is_power_of_2(meta->buffer_size) &&
@@ -190,7 +236,9 @@ inline void metadata_init(
     uint32_t buffer_size,         // Buffer size (must be power of 2)
     uint32_t producer_offset,
     uint32_t consumer_0_offset,
-    uint32_t header_size
+    uint32_t header_size,
+    uint8_t flags = 0,            // METADATA_FLAG_* options
+    uint64_t data_address = 0     // Fixed data segment address (0 = map anywhere)
 ) {
     auto* meta = static_cast<metadata*>(ptr);
     meta->magic = METADATA_MAGIC;
@@ -206,6 +254,8 @@ inline void metadata_init(
     meta->event_size_log2 = event_size ? size_to_log2(event_size) : 0;
     meta->buffer_size_log2 = size_to_log2(buffer_size);
     meta->header_size_log2 = size_to_log2(header_size);
+    meta->flags = flags;
+    meta->data_address = data_address;
     std::fill(std::begin(meta->padding), std::end(meta->padding), 0);
 }
 
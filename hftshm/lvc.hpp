@@ -0,0 +1,213 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "hash.hpp"
+#include "layout.hpp"
+#include "seqlock.hpp"
+
+namespace hftshm {
+
+// ============================================================================
+// Last-Value Cache Segment Layout (<name>.lvc)
+// ============================================================================
+
+// Magic number: "HFTLVC\x00\x01" in little-endian
+inline constexpr uint64_t LVC_MAGIC = 0x0100435654544648ULL;
+
+// Keys are stored as key + 1 so zeroed entries read as empty; this key
+// would wrap to 0 and is rejected
+inline constexpr uint32_t LVC_INVALID_KEY = UINT32_MAX;
+
+// Conflated latest value per key. Entries are an open-addressing table keyed
+// by instrument id; each is one or more whole cache lines holding a seqlock,
+// the key and the value, so a reader that knows the entry pays one miss for a
+// value of up to LVC_INLINE_VALUE_SIZE bytes. Single writer, any readers.
+struct alignas(CACHE_LINE) lvc_header {
+    uint64_t magic;                   // 0x00: LVC_MAGIC
+    uint32_t capacity;                // 0x08: Entries (power of 2)
+    uint32_t value_size;              // 0x0C: Value bytes per entry
+    uint32_t entry_size;              // 0x10: Bytes per entry (cache-line multiple)
+    std::atomic<uint32_t> count;      // 0x14: Keys inserted
+};
+
+struct alignas(CACHE_LINE) lvc_entry {
+    std::atomic<uint32_t> seq;        // 0x00: Seqlock: odd while the writer updates
+    std::atomic<uint32_t> key;        // 0x04: Instrument key + 1 (0 = empty)
+    uint64_t updates;                 // 0x08: Update count (0 = never written)
+    // 0x10: value_size bytes of value
+};
+inline constexpr uint32_t LVC_VALUE_OFFSET = 16;
+inline constexpr uint32_t LVC_INLINE_VALUE_SIZE = CACHE_LINE - LVC_VALUE_OFFSET;
+
+inline uint32_t lvc_entry_size(uint32_t value_size) {
+    uint32_t raw = LVC_VALUE_OFFSET + value_size;
+    return ((raw + CACHE_LINE - 1) / CACHE_LINE) * CACHE_LINE;
+}
+
+// Calculate LVC segment size (page-aligned); capacity is rounded up to a power of 2
+inline std::size_t lvc_size(uint32_t capacity, uint32_t value_size) {
+    std::size_t raw = sizeof(lvc_header) + std::size_t{next_power_of_2(capacity)} * lvc_entry_size(value_size);
+    return ((raw + PAGE_SIZE - 1) / PAGE_SIZE) * PAGE_SIZE;
+}
+
+inline bool lvc_init(void* segment, uint32_t capacity, uint32_t value_size) {
+    if (capacity == 0 || value_size == 0) return false;
+    auto* hdr = static_cast<lvc_header*>(segment);
+    hdr->capacity = next_power_of_2(capacity);
+    hdr->value_size = value_size;
+    hdr->entry_size = lvc_entry_size(value_size);
+    hdr->count.store(0, std::memory_order_relaxed);
+    std::memset(static_cast<char*>(segment) + sizeof(lvc_header), 0,
+                std::size_t{hdr->capacity} * hdr->entry_size);
+    std::atomic_thread_fence(std::memory_order_release);
+    hdr->magic = LVC_MAGIC;
+    return true;
+}
+
+inline bool lvc_validate(const void* segment) {
+    return static_cast<const lvc_header*>(segment)->magic == LVC_MAGIC;
+}
+
+inline lvc_entry* lvc_entry_get(void* segment, uint32_t index) {
+    auto* hdr = static_cast<lvc_header*>(segment);
+    return reinterpret_cast<lvc_entry*>(static_cast<char*>(segment) + sizeof(lvc_header) +
+                                        std::size_t{index} * hdr->entry_size);
+}
+
+inline const lvc_entry* lvc_entry_get(const void* segment, uint32_t index) {
+    return lvc_entry_get(const_cast<void*>(segment), index);
+}
+
+inline char* lvc_value(lvc_entry* e) { return reinterpret_cast<char*>(e) + LVC_VALUE_OFFSET; }
+inline const char* lvc_value(const lvc_entry* e) { return reinterpret_cast<const char*>(e) + LVC_VALUE_OFFSET; }
+
+// Probe for `key`; returns the entry or the empty slot ending its probe run
+// (nullptr if the table is full or key is LVC_INVALID_KEY)
+inline const lvc_entry* lvc_probe(const void* segment, uint32_t key) {
+    if (key == LVC_INVALID_KEY) return nullptr;
+    auto* hdr = static_cast<const lvc_header*>(segment);
+    uint32_t mask = hdr->capacity - 1;
+    for (uint32_t i = key_hash(key) & mask, n = 0; n <= mask; i = (i + 1) & mask, ++n) {
+        const lvc_entry* e = lvc_entry_get(segment, i);
+        uint32_t k = e->key.load(std::memory_order_acquire);
+        if (k == 0 || k == key + 1) return e;
+    }
+    return nullptr;
+}
+
+// ============================================================================
+// LVC Writer
+// ============================================================================
+
+class LvcWriter {
+public:
+    explicit LvcWriter(void* segment)
+        : segment_(segment),
+          hdr_(static_cast<lvc_header*>(segment)) {}
+
+    // Entry for `key`, inserting it if new; nullptr when the table is full
+    // or key is LVC_INVALID_KEY
+    auto entry(uint32_t key) -> lvc_entry* {
+        auto* e = const_cast<lvc_entry*>(lvc_probe(segment_, key));
+        if (!e) return nullptr;
+        if (e->key.load(std::memory_order_relaxed) == 0) {
+            e->key.store(key + 1, std::memory_order_release);
+            hdr_->count.fetch_add(1, std::memory_order_relaxed);
+        }
+        return e;
+    }
+
+    // Replace the value for `key` (value_size bytes); false when the table is
+    // full or key is LVC_INVALID_KEY
+    auto update(uint32_t key, const void* value) -> bool {
+        lvc_entry* e = entry(key);
+        if (!e) return false;
+        update(e, value);
+        return true;
+    }
+
+    // Update a cached entry without probing
+    auto update(lvc_entry* e, const void* value) -> void {
+        uint32_t s = seqlock_write_begin(e->seq);
+        std::memcpy(lvc_value(e), value, hdr_->value_size);
+        ++e->updates;
+        seqlock_write_end(e->seq, s);
+    }
+
+    // Typed update; false if sizeof(T) != value_size or the table is full
+    template <typename T>
+    auto set(uint32_t key, const T& value) -> bool {
+        static_assert(std::is_trivially_copyable_v<T>);
+        return sizeof(T) == hdr_->value_size && update(key, static_cast<const void*>(&value));
+    }
+
+private:
+    void* segment_;
+    lvc_header* hdr_;
+};
+
+// ============================================================================
+// LVC Reader
+// ============================================================================
+
+class LvcReader {
+public:
+    explicit LvcReader(const void* segment)
+        : segment_(segment),
+          hdr_(static_cast<const lvc_header*>(segment)) {}
+
+    // Entry for `key`, or nullptr if it was never written. Cache the result:
+    // entries never move, so later reads skip the probe.
+    auto find(uint32_t key) const -> const lvc_entry* {
+        const lvc_entry* e = lvc_probe(segment_, key);
+        return e && e->key.load(std::memory_order_acquire) == key + 1 ? e : nullptr;
+    }
+
+    // Copy the latest value (value_size bytes) into `out`; false if none yet
+    auto read(uint32_t key, void* out) const -> bool {
+        const lvc_entry* e = find(key);
+        return e && read(e, out);
+    }
+
+    // Consistent copy of a cached entry's value; retries while the writer is mid-update
+    auto read(const lvc_entry* e, void* out) const -> bool {
+        for (;;) {
+            uint32_t s = seqlock_read_begin(e->seq);
+            uint64_t updates = e->updates;
+            std::memcpy(out, lvc_value(e), hdr_->value_size);
+            if (!seqlock_read_retry(e->seq, s)) return updates != 0;
+            cpu_relax();
+        }
+    }
+
+    // Typed read; false if sizeof(T) != value_size or the key has no value
+    template <typename T>
+    auto get(uint32_t key, T& out) const -> bool {
+        static_assert(std::is_trivially_copyable_v<T>);
+        return sizeof(T) == hdr_->value_size && read(key, static_cast<void*>(&out));
+    }
+
+    // Invoke fn(uint32_t key, const lvc_entry*) for every key in the cache
+    template <typename F>
+    auto for_each(F&& fn) const -> void {
+        for (uint32_t i = 0; i < hdr_->capacity; ++i) {
+            const lvc_entry* e = lvc_entry_get(segment_, i);
+            uint32_t k = e->key.load(std::memory_order_acquire);
+            if (k) fn(k - 1, e);
+        }
+    }
+
+    auto value_size() const -> uint32_t { return hdr_->value_size; }
+    auto count() const -> uint32_t { return hdr_->count.load(std::memory_order_relaxed); }
+
+private:
+    const void* segment_;
+    const lvc_header* hdr_;
+};
+
+} // namespace hftshm
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "ring.hpp"
+
+namespace hftshm {
+
+// ============================================================================
+// Merge Reader
+// ============================================================================
+
+// Window value that never emits out of order: wait for every source
+inline constexpr uint64_t MERGE_WINDOW_STRICT = UINT64_MAX;
+
+// Merges K rings into one stream ordered by a uint64_t key (timestamp or
+// global sequence) at a fixed offset in every event.
+//
+// Lookahead is bounded to the head event of each source, kept in a min-heap,
+// plus a peek at the key of each source's newest published event. The smallest
+// head is emitted when every source has a head, or when it is at least `window`
+// older than the newest key seen on any source. A window of 0 favours latency
+// (emit whatever is available); MERGE_WINDOW_STRICT never emits while any
+// source is empty.
+class MergeReader {
+public:
+    MergeReader(uint16_t key_offset, uint64_t window)
+        : key_offset_(key_offset),
+          window_(window) {}
+
+    // Attach to a ring using its consumer section `consumer_id`
+    auto add_source(void* header, void* data, uint8_t consumer_id) -> void {
+        sources_.emplace_back(header, data, consumer_id);
+        sources_.back().attach();
+        queued_.push_back(false);
+    }
+
+    auto detach() -> void {
+        for (auto& s : sources_) s.detach();
+    }
+
+    auto set_window(uint64_t window) -> void { window_ = window; }
+
+    // Invoke fn(const void* event, uint32_t source) for up to max_events events
+    // in key order. Returns the number of events emitted. Only the source just
+    // consumed is refilled per event; empty sources are re-checked on the next poll().
+    template <typename F>
+    auto poll(F&& fn, uint64_t max_events = UINT64_MAX) -> uint64_t {
+        refill_all();
+        uint64_t n = 0;
+        while (n < max_events && !heap_.empty()) {
+            const Head top = heap_.front();
+            if (heap_.size() < sources_.size() && !window_elapsed(top.key)) break;
+
+            std::pop_heap(heap_.begin(), heap_.end(), later);
+            heap_.pop_back();
+            queued_[top.source] = false;
+
+            auto& src = sources_[top.source];
+            fn(src.slot(src.sequence()), top.source);
+            src.advance();
+            ++n;
+
+            refill(top.source);
+        }
+        return n;
+    }
+
+    // Newest key observed on any source
+    auto watermark() const -> uint64_t { return watermark_; }
+
+private:
+    struct Head {
+        uint64_t key;
+        uint32_t source;
+    };
+
+    static auto later(const Head& a, const Head& b) -> bool {
+        return a.key > b.key || (a.key == b.key && a.source > b.source);
+    }
+
+    auto window_elapsed(uint64_t key) const -> bool {
+        if (window_ == MERGE_WINDOW_STRICT) return false;
+        return watermark_ >= window_ && key <= watermark_ - window_;
+    }
+
+    auto key_at(const RingConsumer& src, uint64_t sequence) const -> uint64_t {
+        uint64_t key;
+        std::memcpy(&key, static_cast<const char*>(src.slot(sequence)) + key_offset_, sizeof(key));
+        return key;
+    }
+
+    // Queue the head event of `source` if it has one and isn't queued yet
+    auto refill(uint32_t source) -> void {
+        auto& src = sources_[source];
+        uint64_t avail = src.available();
+        if (avail == 0) return;
+        watermark_ = std::max(watermark_, key_at(src, src.sequence() + avail - 1));
+        if (queued_[source]) return;
+
+        uint64_t key = key_at(src, src.sequence());
+        heap_.push_back({key, source});
+        std::push_heap(heap_.begin(), heap_.end(), later);
+        queued_[source] = true;
+    }
+
+    auto refill_all() -> void {
+        for (uint32_t i = 0; i < sources_.size(); ++i) refill(i);
+    }
+
+    uint16_t key_offset_;
+    uint64_t window_;
+    uint64_t watermark_ = 0;
+    std::vector<RingConsumer> sources_;
+    std::vector<bool> queued_;      // Source has its head in heap_
+    std::vector<Head> heap_;
+};
+
+} // namespace hftshm
@@ -0,0 +1,252 @@
+#pragma once
+
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <signal.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "layout.hpp"
+#include "ring.hpp"
+
+namespace hftshm {
+
+// ============================================================================
+// Multi-Producer Slot Layout
+// ============================================================================
+
+// On METADATA_FLAG_MULTI_PRODUCER rings every slot starts with this header;
+// the event payload follows and is event_size - MP_SLOT_HEADER_SIZE bytes.
+// producer_section::claim hands out sequences; producer_section::cursor is unused.
+struct mp_slot_header {
+    std::atomic<uint64_t> stamp;      // 0x00: ((sequence + 1) << 2) | MP_STATE_*, 0 = never written
+    std::atomic<uint32_t> pid;        // 0x08: Writer PID while MP_STATE_WRITING (0 = not yet known)
+    uint32_t size;                    // 0x0C: Payload bytes written
+};
+inline constexpr uint32_t MP_SLOT_HEADER_SIZE = sizeof(mp_slot_header);
+static_assert(MP_SLOT_HEADER_SIZE == 16);
+
+// Slot states (low two bits of the stamp)
+inline constexpr uint64_t MP_STATE_WRITING   = 1;  // Claimed, payload being written
+inline constexpr uint64_t MP_STATE_PUBLISHED = 2;  // Readable
+inline constexpr uint64_t MP_STATE_ABANDONED = 3;  // Writer died or stalled; skip
+
+// Sequences are stored off by one so a zeroed slot never matches sequence 0
+inline constexpr uint64_t mp_stamp(uint64_t sequence, uint64_t state) {
+    return ((sequence + 1) << 2) | state;
+}
+
+// Default time a claimed sequence may stay unstamped (its producer stalled
+// between fetch_add and taking the slot) before consumers skip it
+inline constexpr std::chrono::milliseconds MP_STALL_TIMEOUT{50};
+
+inline mp_slot_header* mp_slot_get(void* data, const metadata* meta, uint64_t sequence) {
+    return reinterpret_cast<mp_slot_header*>(static_cast<char*>(data) + slot_offset(meta, sequence));
+}
+
+// Clear every slot header (call once when creating the data segment, so
+// stamps left by a previous ring in the same memory are never matched)
+inline void mp_slots_init(void* data, const metadata* meta) {
+    for (uint64_t seq = 0; seq < slot_count(meta); ++seq) {
+        mp_slot_header* hdr = mp_slot_get(data, meta, seq);
+        hdr->stamp.store(0, std::memory_order_relaxed);
+        hdr->pid.store(0, std::memory_order_relaxed);
+        hdr->size = 0;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+// ============================================================================
+// Multi-Producer
+// ============================================================================
+
+// One of many producers on a METADATA_FLAG_MULTI_PRODUCER ring.
+// Sequences are claimed with fetch_add on the shared claim cursor and published
+// per slot by stamping the slot header, so consumers see a slot only once it
+// has been fully written. Nothing in the slot is written until the WRITING
+// stamp is in place, and a slot stamped WRITING is only abandoned once its
+// writer's PID is gone, so a live producer never writes into a slot that has
+// been skipped and reused.
+class MultiProducer {
+public:
+    MultiProducer(void* header, void* data)
+        : header_(header),
+          meta_(metadata_get(header)),
+          prod_(producer_get(header)),
+          data_(static_cast<char*>(data)),
+          slots_(slot_count(meta_)),
+          pid_(static_cast<uint32_t>(::getpid())),
+          gate_(0) {}
+
+    // Claim the next sequence, waiting while the slowest consumer is a full ring behind
+    auto claim() -> uint64_t {
+        for (;;) {
+            uint64_t seq = prod_->claim.fetch_add(1, std::memory_order_acq_rel);
+            while (seq - gate_ >= slots_) {
+                gate_ = min_consumer_cursor(header_, seq);
+            }
+
+            auto* hdr = mp_slot_get(data_, meta_, seq);
+            uint64_t prev = hdr->stamp.load(std::memory_order_acquire);
+            if (prev >= mp_stamp(seq, 0)) continue;   // Abandoned before we got here
+            if (hdr->stamp.compare_exchange_strong(prev, mp_stamp(seq, MP_STATE_WRITING),
+                                                   std::memory_order_acq_rel)) {
+                // Consumers time out a WRITING slot whose PID is still 0; if
+                // that happened before our PID landed, claim again
+                hdr->pid.store(pid_, std::memory_order_seq_cst);
+                if (hdr->stamp.load(std::memory_order_seq_cst) == mp_stamp(seq, MP_STATE_WRITING)) return seq;
+            }
+        }
+    }
+
+    auto payload(uint64_t sequence) -> void* {
+        return reinterpret_cast<char*>(mp_slot_get(data_, meta_, sequence)) + MP_SLOT_HEADER_SIZE;
+    }
+
+    // Publish a claimed sequence. False only if consumers abandoned it, which
+    // requires them to have seen this producer's PID as dead.
+    auto publish(uint64_t sequence, uint32_t size) -> bool {
+        auto* hdr = mp_slot_get(data_, meta_, sequence);
+        hdr->size = size;
+        hdr->pid.store(0, std::memory_order_relaxed);
+        uint64_t expected = mp_stamp(sequence, MP_STATE_WRITING);
+        return hdr->stamp.compare_exchange_strong(expected, mp_stamp(sequence, MP_STATE_PUBLISHED),
+                                                  std::memory_order_release, std::memory_order_relaxed);
+    }
+
+    // Claim, copy and publish one event, re-claiming if the slot was abandoned
+    auto write(const void* event, std::size_t size) -> void {
+        size = std::min<std::size_t>(size, payload_size());
+        do {
+            uint64_t seq = claim();
+            std::memcpy(payload(seq), event, size);
+            if (publish(seq, static_cast<uint32_t>(size))) return;
+        } while (true);
+    }
+
+    auto payload_size() const -> uint32_t { return meta_->event_size - MP_SLOT_HEADER_SIZE; }
+
+private:
+    void* header_;
+    const metadata* meta_;
+    producer_section* prod_;
+    char* data_;
+    uint64_t slots_;
+    uint32_t pid_;
+    uint64_t gate_;     // Cached min consumer cursor
+};
+
+// ============================================================================
+// Multi-Producer Consumer
+// ============================================================================
+
+// Broadcast consumer of a METADATA_FLAG_MULTI_PRODUCER ring.
+// Reads slots in sequence order as their stamps turn PUBLISHED. A claimed slot
+// is abandoned (and skipped by every consumer) once its writer PID is gone, or,
+// if its producer never stamped it WRITING or died before storing its PID,
+// after the stall timeout. A live writer is waited for however long it takes,
+// as is a producer still gated by a consumer a full ring behind.
+class MultiConsumer {
+public:
+    MultiConsumer(void* header, void* data, uint8_t id)
+        : header_(header),
+          meta_(metadata_get(header)),
+          prod_(producer_get(header)),
+          cons_(consumer_get(header, id)),
+          data_(static_cast<char*>(data)),
+          next_(cons_->cursor.load(std::memory_order_relaxed)),
+          stall_timeout_(MP_STALL_TIMEOUT) {}
+
+    // Register with the producers and join at the current claim cursor
+    auto attach() -> void {
+        next_ = prod_->claim.load(std::memory_order_acquire);
+        cons_->cursor.store(next_, std::memory_order_seq_cst);
+        cons_->pid.store(static_cast<uint32_t>(::getpid()), std::memory_order_seq_cst);
+        next_ = std::min(next_, prod_->claim.load(std::memory_order_seq_cst));
+        cons_->cursor.store(next_, std::memory_order_release);
+    }
+
+    auto detach() -> void {
+        cons_->pid.store(0, std::memory_order_release);
+    }
+
+    auto set_stall_timeout(std::chrono::nanoseconds timeout) -> void { stall_timeout_ = timeout; }
+
+    // Invoke fn(const void* payload, uint32_t size) for up to max_events
+    // published events; abandoned slots are skipped.
+    template <typename F>
+    auto poll(F&& fn, uint64_t max_events = UINT64_MAX) -> uint64_t {
+        uint64_t n = 0;
+        uint64_t start = next_;
+        while (n < max_events) {
+            auto* hdr = mp_slot_get(data_, meta_, next_);
+            uint64_t stamp = hdr->stamp.load(std::memory_order_acquire);
+            if (stamp == mp_stamp(next_, MP_STATE_PUBLISHED)) {
+                fn(reinterpret_cast<const char*>(hdr) + MP_SLOT_HEADER_SIZE, hdr->size);
+                ++n;
+            } else if (stamp != mp_stamp(next_, MP_STATE_ABANDONED)) {
+                if (!try_recover(hdr, stamp)) break;
+            }
+            ++next_;
+            stall_seq_ = UINT64_MAX;
+        }
+        if (next_ != start) cons_->cursor.store(next_, std::memory_order_release);
+        return n;
+    }
+
+    auto sequence() const -> uint64_t { return next_; }
+
+private:
+    // Abandon the slot at next_ if its writer is dead, or if it was claimed
+    // but never stamped (or stamped without a PID) within the stall timeout;
+    // its producer then fails the stamp CAS or PID re-check and claims again.
+    // Returns true if the slot is now abandoned (by us or a peer).
+    auto try_recover(mp_slot_header* hdr, uint64_t stamp) -> bool {
+        if (prod_->claim.load(std::memory_order_acquire) <= next_) return false;  // Not claimed yet
+
+        bool writing = stamp == mp_stamp(next_, MP_STATE_WRITING);
+        uint32_t pid = writing ? hdr->pid.load(std::memory_order_seq_cst) : 0;
+        if (pid != 0) {
+            if (::kill(static_cast<pid_t>(pid), 0) == 0 || errno != ESRCH) return false;
+        } else {
+            // An unstamped slot whose claimant is gated by a consumer a full
+            // ring behind still holds the previous lap's unread event
+            if (!writing && min_consumer_cursor(header_, next_) + slot_count(meta_) <= next_) {
+                stall_seq_ = UINT64_MAX;
+                return false;
+            }
+            auto now = std::chrono::steady_clock::now();
+            if (stall_seq_ != next_) {
+                stall_seq_ = next_;
+                stall_since_ = now;
+            }
+            if (now - stall_since_ < stall_timeout_) return false;
+        }
+
+        // On CAS failure a peer abandoned it first, or the producer stamped or
+        // published it; anything but ABANDONED is re-read on the next poll
+        if (hdr->stamp.compare_exchange_strong(stamp, mp_stamp(next_, MP_STATE_ABANDONED),
+                                               std::memory_order_acq_rel)) {
+            hdr->pid.store(0, std::memory_order_relaxed);
+            return true;
+        }
+        return stamp == mp_stamp(next_, MP_STATE_ABANDONED);
+    }
+
+    void* header_;
+    const metadata* meta_;
+    producer_section* prod_;
+    consumer_section* cons_;
+    char* data_;
+    uint64_t next_;                 // Local copy of cons_->cursor
+    std::chrono::nanoseconds stall_timeout_;
+    uint64_t stall_seq_ = UINT64_MAX;
+    std::chrono::steady_clock::time_point stall_since_;
+};
+
+} // namespace hftshm
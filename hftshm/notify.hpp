@@ -0,0 +1,232 @@
+#pragma once
+
+#if defined(__linux__)
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "platform.hpp"
+#include "ring.hpp"
+
+namespace hftshm {
+
+// ============================================================================
+// Ring Notification (Linux eventfd)
+// ============================================================================
+
+// Optional wake-up path for consumers that sleep in epoll_wait instead of
+// spinning. The producer owns one eventfd per consumer section and, after a
+// publish, writes the eventfd of every armed section, so each sleeper has its
+// own counter and one waiter draining it never hides a wake-up from another.
+// With nobody armed the producer pays a fence and one load. A consumer arms
+// its section, re-checks the ring, and only then sleeps; the producer's fence
+// between its cursor store and the waiter check means a publish can't slip
+// between the two.
+//
+// An armed section holds the waiter's PID. The producer re-checks that PID
+// every NOTIFY_LIVENESS_INTERVAL writes to a section and disarms sections
+// whose waiter has died, so a crashed consumer stops costing it syscalls.
+
+// Writes to one armed section between checks that its waiter is alive
+inline constexpr uint32_t NOTIFY_LIVENESS_INTERVAL = 64;
+
+// ============================================================================
+// Ring Notifier (producer side)
+// ============================================================================
+
+class RingNotifier {
+public:
+    explicit RingNotifier(void* header)
+        : header_(header),
+          prod_(producer_get(header)),
+          fds_(metadata_get(header)->max_consumers, -1),
+          writes_(fds_.size(), 0) {
+        for (std::size_t i = 0; i < fds_.size(); ++i) {
+            fds_[i] = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (fds_[i] < 0) {
+                int err = errno;
+                close_all();
+                throw policies::PlatformError(std::string("hftshm: eventfd failed: ") + std::strerror(err));
+            }
+            consumer_get(header, static_cast<uint8_t>(i))->notify_fd.store(fds_[i], std::memory_order_relaxed);
+        }
+        prod_->notify_pid.store(static_cast<uint32_t>(::getpid()), std::memory_order_release);
+    }
+
+    RingNotifier(const RingNotifier&) = delete;
+    auto operator=(const RingNotifier&) -> RingNotifier& = delete;
+
+    ~RingNotifier() {
+        prod_->notify_pid.store(0, std::memory_order_release);
+        close_all();
+    }
+
+    // Call after RingProducer::publish(); syscalls only if a consumer sleeps
+    auto notify() -> void {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (prod_->notify_waiters.load(std::memory_order_relaxed) != 0) signal();
+    }
+
+    // Eventfd of consumer section `id`, in this process
+    auto fd(uint8_t id) const -> int { return fds_[id]; }
+
+private:
+    // Wake every armed section, disarming those whose waiter has died
+    auto signal() -> void {
+        for (std::size_t i = 0; i < fds_.size(); ++i) {
+            auto* cons = consumer_get(header_, static_cast<uint8_t>(i));
+            uint32_t pid = cons->notify_armed.load(std::memory_order_relaxed);
+            if (pid == 0) continue;
+            if (++writes_[i] % NOTIFY_LIVENESS_INTERVAL == 0 &&
+                ::kill(static_cast<pid_t>(pid), 0) != 0 && errno == ESRCH) {
+                // A new waiter may have replaced the dead one; only clear our own view
+                if (cons->notify_armed.compare_exchange_strong(pid, 0, std::memory_order_relaxed)) {
+                    prod_->notify_waiters.fetch_sub(1, std::memory_order_relaxed);
+                }
+                continue;
+            }
+            uint64_t one = 1;
+            [[maybe_unused]] ssize_t rc = ::write(fds_[i], &one, sizeof(one));
+        }
+    }
+
+    auto close_all() -> void {
+        for (int& fd : fds_) {
+            if (fd >= 0) ::close(fd);
+            fd = -1;
+        }
+    }
+
+    void* header_;
+    producer_section* prod_;
+    std::vector<int> fds_;            // Per consumer section
+    std::vector<uint32_t> writes_;    // Per section, paces liveness checks
+};
+
+// Duplicate consumer section `id`'s eventfd into this process with
+// pidfd_getfd() (Linux 5.6+, needs ptrace access to the producer). Returns -1
+// with errno set on failure. The only other way to get the fd is from the
+// producer over a unix socket (SCM_RIGHTS), passed to NotifyWaiter directly;
+// /proc/<pid>/fd cannot reopen an eventfd.
+inline int open_notify_fd(void* header, uint8_t id) {
+    producer_section* prod = producer_get(header);
+    auto pid = static_cast<pid_t>(prod->notify_pid.load(std::memory_order_acquire));
+    int fd = consumer_get(header, id)->notify_fd.load(std::memory_order_relaxed);
+    if (pid == 0) {
+        errno = ENOENT;
+        return -1;
+    }
+    if (pid == ::getpid()) return ::fcntl(fd, F_DUPFD_CLOEXEC, 0);
+
+#if defined(SYS_pidfd_open) && defined(SYS_pidfd_getfd)
+    int pidfd = static_cast<int>(::syscall(SYS_pidfd_open, pid, 0));
+    if (pidfd < 0) return -1;
+    int local = static_cast<int>(::syscall(SYS_pidfd_getfd, pidfd, fd, 0));
+    int err = errno;
+    ::close(pidfd);
+    errno = err;
+    return local;
+#else
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+// ============================================================================
+// Notify Waiter (consumer side)
+// ============================================================================
+
+// Sleeping side for the consumer bound to section `id`; one waiter per section.
+class NotifyWaiter {
+public:
+    // fd: the section's eventfd from the producer (SCM_RIGHTS), or -1 to
+    // fetch it with open_notify_fd()
+    NotifyWaiter(void* header, uint8_t id, int fd = -1)
+        : prod_(producer_get(header)),
+          cons_(consumer_get(header, id)),
+          fd_(fd >= 0 ? fd : open_notify_fd(header, id)),
+          pid_(static_cast<uint32_t>(::getpid())),
+          armed_(false) {
+        if (fd_ < 0) {
+            throw policies::PlatformError(std::string("hftshm: cannot open ring eventfd: ") + std::strerror(errno));
+        }
+    }
+
+    NotifyWaiter(const NotifyWaiter&) = delete;
+    auto operator=(const NotifyWaiter&) -> NotifyWaiter& = delete;
+
+    ~NotifyWaiter() {
+        disarm();
+        ::close(fd_);
+    }
+
+    // Request a wake-up for the next publish. Returns false, without arming,
+    // if `consumer` already has events (process them instead of sleeping).
+    auto arm(RingConsumer& consumer) -> bool {
+        if (!armed_) {
+            // A dead waiter's PID left in the section is already counted
+            if (cons_->notify_armed.exchange(pid_, std::memory_order_seq_cst) == 0) {
+                prod_->notify_waiters.fetch_add(1, std::memory_order_seq_cst);
+            }
+            armed_ = true;
+        }
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (consumer.available() > 0) {
+            disarm();
+            return false;
+        }
+        return true;
+    }
+
+    auto disarm() -> void {
+        if (!armed_) return;
+        uint32_t pid = pid_;
+        if (cons_->notify_armed.compare_exchange_strong(pid, 0, std::memory_order_relaxed)) {
+            prod_->notify_waiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+        armed_ = false;
+    }
+
+    // After epoll reports the fd readable: reset the counter and disarm
+    auto consume() -> void {
+        uint64_t value;
+        [[maybe_unused]] ssize_t rc = ::read(fd_, &value, sizeof(value));
+        disarm();
+    }
+
+    // Sleep until events are available or timeout_ms elapses (-1 = forever),
+    // for consumers without their own epoll loop. Returns true if events are ready.
+    auto wait(RingConsumer& consumer, int timeout_ms) -> bool {
+        if (!arm(consumer)) return true;
+        pollfd pfd{fd_, POLLIN, 0};
+        ::poll(&pfd, 1, timeout_ms);
+        consume();
+        return consumer.available() > 0;
+    }
+
+    auto fd() const -> int { return fd_; }
+    auto armed() const -> bool { return armed_; }
+
+private:
+    producer_section* prod_;
+    consumer_section* cons_;
+    int fd_;
+    uint32_t pid_;
+    bool armed_;
+};
+
+} // namespace hftshm
+
+#endif // __linux__
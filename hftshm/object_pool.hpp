@@ -0,0 +1,189 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "layout.hpp"
+
+namespace hftshm {
+
+// ============================================================================
+// Object Pool Segment Layout
+// ============================================================================
+
+// Magic number: "HFTPOOL\x01" in little-endian
+inline constexpr uint64_t OBJECT_POOL_MAGIC = 0x014C4F4F50544648ULL;
+
+// Objects are named by index, which every attached process can resolve
+inline constexpr uint32_t POOL_NULL_INDEX = UINT32_MAX;
+
+// Free list head packs a 32-bit tag above the index; every successful CAS
+// bumps the tag, so a head popped and pushed back in between can't match (ABA).
+inline constexpr uint64_t pool_head(uint32_t tag, uint32_t index) {
+    return (uint64_t{tag} << 32) | index;
+}
+inline constexpr uint32_t pool_head_index(uint64_t head) { return static_cast<uint32_t>(head); }
+inline constexpr uint32_t pool_head_tag(uint64_t head) { return static_cast<uint32_t>(head >> 32); }
+
+struct alignas(CACHE_LINE) object_pool_header {
+    uint64_t magic;                       // 0x00: OBJECT_POOL_MAGIC
+    uint32_t object_size;                 // 0x08: Bytes per object (cache-line multiple)
+    uint32_t capacity;                    // 0x0C: Object count
+    uint32_t objects_offset;              // 0x10: Offset of object 0 from segment start
+    uint32_t reserved;                    // 0x14
+    alignas(CACHE_LINE) std::atomic<uint64_t> free_head;    // Tag | index of first free object
+};
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+// Free list links follow the header, one per object
+inline std::atomic<uint32_t>* pool_links(void* pool) {
+    return reinterpret_cast<std::atomic<uint32_t>*>(static_cast<char*>(pool) + sizeof(object_pool_header));
+}
+
+inline uint32_t pool_object_size(uint32_t object_size) {
+    return ((object_size + CACHE_LINE - 1) / CACHE_LINE) * CACHE_LINE;
+}
+
+inline uint32_t pool_objects_offset(uint32_t capacity) {
+    uint32_t links = sizeof(object_pool_header) + capacity * sizeof(uint32_t);
+    return ((links + CACHE_LINE - 1) / CACHE_LINE) * CACHE_LINE;
+}
+
+// Calculate object pool segment size (page-aligned)
+inline std::size_t object_pool_size(uint32_t object_size, uint32_t capacity) {
+    std::size_t raw = pool_objects_offset(capacity) + std::size_t{pool_object_size(object_size)} * capacity;
+    return ((raw + PAGE_SIZE - 1) / PAGE_SIZE) * PAGE_SIZE;
+}
+
+// Initialize a pool with every object free
+inline bool object_pool_init(void* pool, uint32_t object_size, uint32_t capacity) {
+    if (object_size == 0 || capacity == 0 || capacity == POOL_NULL_INDEX) return false;
+    auto* hdr = static_cast<object_pool_header*>(pool);
+    hdr->object_size = pool_object_size(object_size);
+    hdr->capacity = capacity;
+    hdr->objects_offset = pool_objects_offset(capacity);
+    hdr->reserved = 0;
+
+    std::atomic<uint32_t>* links = pool_links(pool);
+    for (uint32_t i = 0; i < capacity; ++i) {
+        links[i].store(i + 1 < capacity ? i + 1 : POOL_NULL_INDEX, std::memory_order_relaxed);
+    }
+    hdr->free_head.store(pool_head(0, 0), std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    hdr->magic = OBJECT_POOL_MAGIC;
+    return true;
+}
+
+inline bool object_pool_validate(const void* pool) {
+    return static_cast<const object_pool_header*>(pool)->magic == OBJECT_POOL_MAGIC;
+}
+
+// ============================================================================
+// Object Pool (per-process handle)
+// ============================================================================
+
+inline constexpr uint32_t POOL_MAGAZINE_SIZE = 64;
+inline constexpr uint32_t POOL_MAGAZINE_BATCH = POOL_MAGAZINE_SIZE / 2;
+
+// Lock-free fixed-size object pool shared by any number of processes.
+// Each ObjectPool keeps a magazine of free indices; alloc/free touch only the
+// magazine, and the shared free list is hit once per POOL_MAGAZINE_BATCH
+// objects with a single CAS moving a whole chain. Not thread-safe: use one
+// object per thread. A process that dies holding a magazine leaks its
+// contents until the pool is re-initialized.
+class ObjectPool {
+public:
+    explicit ObjectPool(void* pool)
+        : hdr_(static_cast<object_pool_header*>(pool)),
+          links_(pool_links(pool)),
+          objects_(static_cast<char*>(pool) + hdr_->objects_offset),
+          object_size_(hdr_->object_size),
+          count_(0) {}
+
+    ObjectPool(const ObjectPool&) = delete;
+    auto operator=(const ObjectPool&) -> ObjectPool& = delete;
+
+    ~ObjectPool() { flush(); }
+
+    // Returns an object index, or POOL_NULL_INDEX when the pool is exhausted
+    auto alloc() -> uint32_t {
+        if (count_ == 0 && !refill()) return POOL_NULL_INDEX;
+        return magazine_[--count_];
+    }
+
+    auto free(uint32_t index) -> void {
+        if (count_ == POOL_MAGAZINE_SIZE) drain(POOL_MAGAZINE_BATCH);
+        magazine_[count_++] = index;
+    }
+
+    // Return every cached index to the shared free list
+    auto flush() -> void {
+        if (count_) drain(count_);
+    }
+
+    auto ptr(uint32_t index) const -> void* {
+        return objects_ + std::size_t{index} * object_size_;
+    }
+
+    auto index(const void* p) const -> uint32_t {
+        return static_cast<uint32_t>((static_cast<const char*>(p) - objects_) / object_size_);
+    }
+
+    template <typename T>
+    auto get(uint32_t index) const -> T* { return static_cast<T*>(ptr(index)); }
+
+    auto capacity() const -> uint32_t { return hdr_->capacity; }
+    auto object_size() const -> uint32_t { return object_size_; }
+    auto cached() const -> uint32_t { return count_; }
+
+private:
+    // Pop up to POOL_MAGAZINE_BATCH indices in one CAS. The links walked are
+    // only trusted if the tag is unchanged, i.e. nobody popped or pushed since.
+    auto refill() -> bool {
+        uint64_t head = hdr_->free_head.load(std::memory_order_acquire);
+        for (;;) {
+            uint32_t first = pool_head_index(head);
+            if (first == POOL_NULL_INDEX) return false;
+
+            uint32_t n = 0;
+            uint32_t next = first;
+            while (n < POOL_MAGAZINE_BATCH && next != POOL_NULL_INDEX) {
+                magazine_[n++] = next;
+                next = links_[next].load(std::memory_order_relaxed);
+            }
+            if (hdr_->free_head.compare_exchange_weak(head, pool_head(pool_head_tag(head) + 1, next),
+                                                      std::memory_order_acquire,
+                                                      std::memory_order_acquire)) {
+                count_ = n;
+                return true;
+            }
+        }
+    }
+
+    // Link the top n magazine entries into a chain and push it in one CAS
+    auto drain(uint32_t n) -> void {
+        uint32_t first = magazine_[count_ - 1];
+        uint32_t last = magazine_[count_ - n];
+        for (uint32_t i = count_ - 1; i > count_ - n; --i) {
+            links_[magazine_[i]].store(magazine_[i - 1], std::memory_order_relaxed);
+        }
+        count_ -= n;
+
+        uint64_t head = hdr_->free_head.load(std::memory_order_relaxed);
+        do {
+            links_[last].store(pool_head_index(head), std::memory_order_relaxed);
+        } while (!hdr_->free_head.compare_exchange_weak(head, pool_head(pool_head_tag(head) + 1, first),
+                                                        std::memory_order_release,
+                                                        std::memory_order_relaxed));
+    }
+
+    object_pool_header* hdr_;
+    std::atomic<uint32_t>* links_;
+    char* objects_;
+    uint32_t object_size_;
+    uint32_t count_;
+    uint32_t magazine_[POOL_MAGAZINE_SIZE];
+};
+
+} // namespace hftshm
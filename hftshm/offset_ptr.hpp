@@ -0,0 +1,138 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "layout.hpp"
+
+namespace hftshm {
+
+// ============================================================================
+// Offset Pointer
+// ============================================================================
+
+// Self-relative pointer: stores the distance from its own address to the
+// target, so a structure built in a segment is valid wherever each process
+// maps it. Dereference costs one add - no per-process base lookup.
+// Offset 0 encodes nullptr, so zeroed segment memory holds null pointers;
+// a pointer to itself is stored as 1 (an object can't point one byte past
+// itself).
+template <typename T>
+class offset_ptr {
+public:
+    using element_type = T;
+
+    offset_ptr() : off_(NULL_OFFSET) {}
+    offset_ptr(std::nullptr_t) : off_(NULL_OFFSET) {}
+    offset_ptr(T* p) { set(p); }
+    offset_ptr(const offset_ptr& other) { set(other.get()); }
+
+    auto operator=(const offset_ptr& other) -> offset_ptr& {
+        set(other.get());
+        return *this;
+    }
+
+    auto operator=(T* p) -> offset_ptr& {
+        set(p);
+        return *this;
+    }
+
+    auto get() const -> T* {
+        if (off_ == NULL_OFFSET) return nullptr;
+        intptr_t off = off_ == SELF_OFFSET ? 0 : off_;
+        return reinterpret_cast<T*>(reinterpret_cast<intptr_t>(this) + off);
+    }
+
+    auto operator->() const -> T* { return get(); }
+
+    template <typename U = T, typename = std::enable_if_t<!std::is_void_v<U>>>
+    auto operator*() const -> U& { return *get(); }
+
+    template <typename U = T, typename = std::enable_if_t<!std::is_void_v<U>>>
+    auto operator[](std::size_t i) const -> U& { return get()[i]; }
+
+    explicit operator bool() const { return off_ != NULL_OFFSET; }
+
+    friend auto operator==(const offset_ptr& a, const offset_ptr& b) -> bool { return a.get() == b.get(); }
+    friend auto operator!=(const offset_ptr& a, const offset_ptr& b) -> bool { return a.get() != b.get(); }
+
+private:
+    static constexpr intptr_t NULL_OFFSET = 0;
+    static constexpr intptr_t SELF_OFFSET = 1;
+
+    auto set(T* p) -> void {
+        if (!p) {
+            off_ = NULL_OFFSET;
+            return;
+        }
+        intptr_t off = reinterpret_cast<intptr_t>(p) - reinterpret_cast<intptr_t>(this);
+        off_ = off == 0 ? SELF_OFFSET : off;
+    }
+
+    intptr_t off_;
+};
+static_assert(sizeof(offset_ptr<int>) == 8);
+static_assert(std::is_standard_layout_v<offset_ptr<int>>);
+
+// ============================================================================
+// Shared Arena
+// ============================================================================
+
+// Magic number: "HFTARENA" in little-endian
+inline constexpr uint64_t ARENA_MAGIC = 0x414E455241544648ULL;
+
+// Bump allocator at the start of a segment. Allocation is a lock-free CAS on
+// `used`, so several processes may allocate; memory is released only by
+// re-initializing the whole arena.
+struct alignas(CACHE_LINE) shm_arena {
+    uint64_t magic;                   // 0x00: ARENA_MAGIC
+    uint64_t size;                    // 0x08: Segment size in bytes
+    std::atomic<uint64_t> used;       // 0x10: Bytes allocated (including this header)
+    offset_ptr<void> root;            // 0x18: Entry point to the segment's data structures
+};
+
+inline shm_arena* arena_init(void* ptr, std::size_t size) {
+    auto* arena = static_cast<shm_arena*>(ptr);
+    arena->size = size;
+    arena->used.store(sizeof(shm_arena), std::memory_order_relaxed);
+    arena->root = nullptr;
+    std::atomic_thread_fence(std::memory_order_release);
+    arena->magic = ARENA_MAGIC;
+    return arena;
+}
+
+inline shm_arena* arena_get(void* ptr) {
+    auto* arena = static_cast<shm_arena*>(ptr);
+    return arena->magic == ARENA_MAGIC ? arena : nullptr;
+}
+
+// Allocate `size` bytes aligned to `align` (power of 2); nullptr when exhausted
+inline void* arena_alloc(shm_arena* arena, std::size_t size, std::size_t align = alignof(std::max_align_t)) {
+    uint64_t used = arena->used.load(std::memory_order_relaxed);
+    uint64_t start;
+    do {
+        start = (used + align - 1) & ~static_cast<uint64_t>(align - 1);
+        if (start + size > arena->size) return nullptr;
+    } while (!arena->used.compare_exchange_weak(used, start + size, std::memory_order_relaxed));
+    return reinterpret_cast<char*>(arena) + start;
+}
+
+// Uninitialized storage for `count` objects of T
+template <typename T>
+inline T* arena_alloc_array(shm_arena* arena, std::size_t count) {
+    return static_cast<T*>(arena_alloc(arena, sizeof(T) * count, alignof(T)));
+}
+
+// Construct one T in the arena; nullptr when exhausted
+template <typename T, typename... Args>
+inline T* arena_new(shm_arena* arena, Args&&... args) {
+    void* p = arena_alloc(arena, sizeof(T), alignof(T));
+    return p ? new (p) T(std::forward<Args>(args)...) : nullptr;
+}
+
+} // namespace hftshm
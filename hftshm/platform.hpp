@@ -26,6 +26,23 @@ struct PlatformError : std::runtime_error {
     using std::runtime_error::runtime_error;
 };
 
+// Verify a fixed-address mmap result; unmaps and throws on mismatch
+inline auto check_fixed(void* ptr, void* address, std::size_t size) -> void* {
+    if (ptr == MAP_FAILED) {
+        std::ostringstream oss;
+        oss << "hftshm: cannot map " << size << " bytes at fixed address " << address
+            << ": " << std::strerror(errno);
+        throw PlatformError(oss.str());
+    }
+    if (ptr != address) {
+        ::munmap(ptr, size);
+        std::ostringstream oss;
+        oss << "hftshm: fixed address " << address << " unavailable (kernel mapped at " << ptr << ")";
+        throw PlatformError(oss.str());
+    }
+    return ptr;
+}
+
 #if defined(__linux__)
 
 // Linux shared memory policy
@@ -49,6 +66,22 @@ struct LinuxShmPolicy {
         return get_path(name) + ".dat";
     }
 
+    auto get_route_path(std::string_view name) const -> std::string {
+        return get_path(name) + ".rt";
+    }
+
+    auto get_blob_path(std::string_view name) const -> std::string {
+        return get_path(name) + ".blob";
+    }
+
+    auto get_lvc_path(std::string_view name) const -> std::string {
+        return get_path(name) + ".lvc";
+    }
+
+    auto get_book_path(std::string_view name) const -> std::string {
+        return get_path(name) + ".book";
+    }
+
     auto create(std::string_view name, std::size_t size, std::size_t hugepage_size) const -> int {
         ensure_base_dir();
         auto path = get_path(name);
@@ -100,6 +133,35 @@ struct LinuxShmPolicy {
         return (ptr == MAP_FAILED) ? nullptr : ptr;
     }
 
+    // Map at exactly `address` without replacing existing mappings.
+    // Throws PlatformError if the range is taken or the kernel ignores the request.
+    auto map(int fd, std::size_t size, std::size_t hugepage_size, void* address) const -> void* {
+        int flags = MAP_SHARED;
+#ifdef MAP_FIXED_NOREPLACE
+        flags |= MAP_FIXED_NOREPLACE;
+#endif
+        if (hugepage_size > 0) {
+#ifdef MAP_HUGETLB
+            flags |= MAP_HUGETLB;
+#ifdef MAP_HUGE_2MB
+            if (hugepage_size == HUGEPAGE_2MB) flags |= MAP_HUGE_2MB;
+#endif
+#ifdef MAP_HUGE_1GB
+            if (hugepage_size == HUGEPAGE_1GB) flags |= MAP_HUGE_1GB;
+#endif
+#endif
+        }
+
+        void* ptr = ::mmap(address, size, PROT_READ | PROT_WRITE, flags, fd, 0);
+
+        if (ptr == MAP_FAILED && hugepage_size > 0 && errno != EEXIST) {
+            // Fallback to regular pages
+            ptr = ::mmap(address, size, PROT_READ | PROT_WRITE, flags & ~MAP_HUGETLB, fd, 0);
+        }
+
+        return check_fixed(ptr, address, size);
+    }
+
     auto open(std::string_view name) const -> int {
         return ::open(get_path(name).c_str(), O_RDWR);
     }
@@ -186,6 +248,22 @@ struct MacOSShmPolicy {
         return get_path(name) + ".dat";
     }
 
+    auto get_route_path(std::string_view name) const -> std::string {
+        return get_path(name) + ".rt";
+    }
+
+    auto get_blob_path(std::string_view name) const -> std::string {
+        return get_path(name) + ".blob";
+    }
+
+    auto get_lvc_path(std::string_view name) const -> std::string {
+        return get_path(name) + ".lvc";
+    }
+
+    auto get_book_path(std::string_view name) const -> std::string {
+        return get_path(name) + ".book";
+    }
+
     auto create(std::string_view name, std::size_t size, std::size_t /*hugepage_size*/) const -> int {
         ensure_base_dir();
         auto path = get_path(name);
@@ -217,6 +295,13 @@ struct MacOSShmPolicy {
         return (ptr == MAP_FAILED) ? nullptr : ptr;
     }
 
+    // Map at exactly `address` (passed as a hint; no MAP_FIXED_NOREPLACE on macOS).
+    // Throws PlatformError if the range is taken.
+    auto map(int fd, std::size_t size, std::size_t /*hugepage_size*/, void* address) const -> void* {
+        void* ptr = ::mmap(address, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        return check_fixed(ptr, address, size);
+    }
+
     auto open(std::string_view name) const -> int {
         return ::open(get_path(name).c_str(), O_RDWR);
     }
@@ -282,6 +367,15 @@ struct MacOSShmPolicy {
 
 #endif
 
+// Map a ring's data segment, at meta->data_address when one is recorded so
+// raw pointers into the segment are valid in every attached process
+template <typename Policy>
+inline auto map_data_segment(const Policy& policy, const metadata* meta,
+                             int fd, std::size_t size, std::size_t hugepage_size) -> void* {
+    if (meta->data_address == 0) return policy.map(fd, size, hugepage_size);
+    return policy.map(fd, size, hugepage_size, reinterpret_cast<void*>(meta->data_address));
+}
+
 // Default platform policy based on OS
 #if defined(__linux__)
 using DefaultPlatformPolicy = LinuxShmPolicy;
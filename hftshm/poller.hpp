@@ -0,0 +1,181 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "layout.hpp"
+#include "ring.hpp"
+
+namespace hftshm {
+
+// ============================================================================
+// Ready Set Segment Layout
+// ============================================================================
+
+// Magic number: "HFTREADY" in little-endian
+inline constexpr uint64_t READY_SET_MAGIC = 0x5944414552544648ULL;
+
+// Rings per ready set: one summary bit per 64-ring word
+inline constexpr uint32_t READY_MAX_RINGS = 64 * 64;
+
+// Shared "ring has data" bitmap for one poller and many producers. A producer
+// sets its ring's bit (and the word's summary bit) after publishing, but only
+// when the bit is clear, so a busy ring pays one load per publish. The poller
+// finds active rings with one load of `summary` plus one per flagged word.
+struct alignas(CACHE_LINE) ready_set {
+    uint64_t magic;                   // 0x00: READY_SET_MAGIC
+    uint32_t capacity;                // 0x08: Rings (multiple of 64)
+    uint32_t reserved;                // 0x0C
+
+    // Second cache line: bit w set when words[w] may be nonzero
+    alignas(CACHE_LINE) std::atomic<uint64_t> summary;
+    // Third cache line onward: capacity / 64 words, bit b of word w = ring w * 64 + b
+};
+
+inline std::atomic<uint64_t>* ready_words(void* segment) {
+    return reinterpret_cast<std::atomic<uint64_t>*>(static_cast<char*>(segment) + sizeof(ready_set));
+}
+
+// Calculate ready set segment size (page-aligned)
+inline std::size_t ready_set_size(uint32_t capacity) {
+    std::size_t raw = sizeof(ready_set) + ((capacity + 63) / 64) * sizeof(uint64_t);
+    return ((raw + PAGE_SIZE - 1) / PAGE_SIZE) * PAGE_SIZE;
+}
+
+inline bool ready_set_init(void* segment, uint32_t capacity) {
+    if (capacity == 0 || capacity > READY_MAX_RINGS) return false;
+    auto* rs = static_cast<ready_set*>(segment);
+    rs->capacity = (capacity + 63) & ~63u;
+    rs->reserved = 0;
+    rs->summary.store(0, std::memory_order_relaxed);
+    std::atomic<uint64_t>* words = ready_words(segment);
+    for (uint32_t w = 0; w < rs->capacity / 64; ++w) words[w].store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    rs->magic = READY_SET_MAGIC;
+    return true;
+}
+
+inline bool ready_set_validate(const void* segment) {
+    return static_cast<const ready_set*>(segment)->magic == READY_SET_MAGIC;
+}
+
+// ============================================================================
+// Ready Signal (producer side)
+// ============================================================================
+
+// Marks one ring ready; call signal() after RingProducer::publish().
+class ReadySignal {
+public:
+    ReadySignal(void* segment, uint32_t ring_index)
+        : summary_(&static_cast<ready_set*>(segment)->summary),
+          word_(ready_words(segment) + ring_index / 64),
+          bit_(uint64_t{1} << (ring_index % 64)),
+          summary_bit_(uint64_t{1} << (ring_index / 64)) {}
+
+    auto signal() -> void {
+        // Order the cursor store before the bit check; pairs with the
+        // poller clearing the bit before it reads the cursor
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!(word_->load(std::memory_order_relaxed) & bit_)) {
+            word_->fetch_or(bit_, std::memory_order_seq_cst);
+        }
+        if (!(summary_->load(std::memory_order_relaxed) & summary_bit_)) {
+            summary_->fetch_or(summary_bit_, std::memory_order_seq_cst);
+        }
+    }
+
+private:
+    std::atomic<uint64_t>* summary_;
+    std::atomic<uint64_t>* word_;
+    uint64_t bit_;
+    uint64_t summary_bit_;
+};
+
+// ============================================================================
+// Multi-Ring Poller
+// ============================================================================
+
+// Services many rings from one thread. Each poll() takes the ready bits
+// (clearing them before reading any cursor, so a publish racing with the
+// drain re-flags its ring), then drains up to `batch` events per ready ring,
+// visiting rings round-robin from where the previous sweep stopped. Rings
+// left non-empty by the batch limit stay pending for the next sweep.
+class MultiRingPoller {
+public:
+    explicit MultiRingPoller(void* segment)
+        : rs_(static_cast<ready_set*>(segment)),
+          words_(ready_words(segment)),
+          nwords_(rs_->capacity / 64),
+          rings_(rs_->capacity),
+          ready_(nwords_, 0),
+          next_(0) {}
+
+    // Follow a ring signalled at `ring_index`, via its consumer section `consumer_id`
+    auto add_ring(uint32_t ring_index, void* header, void* data, uint8_t consumer_id) -> void {
+        rings_[ring_index].emplace(header, data, consumer_id);
+        rings_[ring_index]->attach();
+        // Events published before attaching may never be signalled
+        ready_[ring_index / 64] |= uint64_t{1} << (ring_index % 64);
+    }
+
+    auto detach() -> void {
+        for (auto& r : rings_) {
+            if (r) r->detach();
+        }
+    }
+
+    // Invoke fn(const void* event, uint32_t ring_index) for up to `batch`
+    // events per ready ring. Returns the number of events delivered.
+    template <typename F>
+    auto poll(F&& fn, uint64_t batch = 64) -> uint64_t {
+        collect();
+        const uint32_t count = nwords_ * 64;
+        uint64_t total = 0;
+        uint32_t last = next_;
+        for (uint32_t k = 0; k < count; ++k) {
+            uint32_t i = next_ + k < count ? next_ + k : next_ + k - count;
+            uint64_t& word = ready_[i / 64];
+            if (!word) {
+                k += 63 - i % 64;   // Skip the rest of an empty word
+                continue;
+            }
+            uint64_t bit = uint64_t{1} << (i % 64);
+            if (!(word & bit)) continue;
+
+            word &= ~bit;
+            auto& ring = rings_[i];
+            if (!ring) continue;
+            total += ring->poll([&](const void* event) { fn(event, i); }, batch);
+            if (ring->available()) word |= bit;
+            last = i + 1 < count ? i + 1 : 0;
+        }
+        next_ = last;
+        return total;
+    }
+
+private:
+    // Move shared ready bits into the local pending set
+    auto collect() -> void {
+        uint64_t summary = rs_->summary.load(std::memory_order_relaxed);
+        if (!summary) return;
+        summary = rs_->summary.exchange(0, std::memory_order_seq_cst);
+        for (; summary; summary &= summary - 1) {
+            uint32_t w = static_cast<uint32_t>(__builtin_ctzll(summary));
+            if (w < nwords_) ready_[w] |= words_[w].exchange(0, std::memory_order_seq_cst);
+        }
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    ready_set* rs_;
+    std::atomic<uint64_t>* words_;
+    uint32_t nwords_;
+    std::vector<std::optional<RingConsumer>> rings_;
+    std::vector<uint64_t> ready_;     // Pending rings (taken from the shared set or left over)
+    uint32_t next_;                   // Round-robin start for the next sweep
+};
+
+} // namespace hftshm
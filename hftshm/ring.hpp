@@ -0,0 +1,421 @@
+#pragma once
+
+#include <atomic>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include "layout.hpp"
+#include "copy.hpp"
+
+namespace hftshm {
+
+// ============================================================================
+// Producer / Consumer Sections (Header File Layout)
+// ============================================================================
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared cursors must be lock-free");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "Shared cursors must be lock-free");
+
+// Consumer flags
+inline constexpr uint32_t CONSUMER_FLAG_ROUTED = 0x01;  // Reads only producer-routed events
+inline constexpr uint32_t CONSUMER_FLAG_GROUP = 0x02;   // Work-distributing group started and joinable
+
+// Consumers that can be named in a dependency mask
+inline constexpr uint8_t MAX_DEPENDENCY_ID = 63;
+
+// Producer section (at meta->producer_offset)
+// Sequences [0, cursor) are published and readable by consumers.
+struct alignas(CACHE_LINE) producer_section {
+    std::atomic<uint64_t> cursor;         // 0x00: Next sequence to publish
+    std::atomic<uint32_t> route_epoch;    // 0x08: Bumped when any consumer's interest changes
+
+    // Second cache line: shared claim cursor (METADATA_FLAG_MULTI_PRODUCER rings
+    // only), then notification state (notify.hpp), off the cursor's line
+    alignas(CACHE_LINE) std::atomic<uint64_t> claim;
+    std::atomic<uint32_t> notify_waiters; // Consumer sections armed for notification
+    std::atomic<uint32_t> notify_pid;     // PID owning the sections' eventfds (0 = no notifier)
+};
+static_assert(sizeof(producer_section) <= DEFAULT_PRODUCER_SECTION_SIZE);
+
+// Consumer section (at consumer_offset(meta, n))
+// The producer never overwrites a slot an attached consumer has not read.
+struct alignas(CACHE_LINE) consumer_section {
+    std::atomic<uint64_t> cursor;       // 0x00: Next sequence to read
+    std::atomic<uint32_t> pid;          // 0x08: Consumer PID (0 = not attached)
+    std::atomic<uint32_t> flags;        // 0x0C: CONSUMER_FLAG_* options
+    std::atomic<uint64_t> depends;      // 0x10: Upstream consumer ids (bit n = section n)
+    std::atomic<uint32_t> annotation;   // 0x18: Owned slot bytes, offset << 16 | length (annotation.hpp)
+    std::atomic<uint32_t> workers;      // 0x1C: Attached workers (consumer groups, group.hpp)
+    std::atomic<uint64_t> claim;        // 0x20: Next sequence to hand out (consumer groups)
+    std::atomic<uint32_t> notify_armed; // 0x28: PID sleeping until notified, 0 = none (notify.hpp)
+    std::atomic<int32_t>  notify_fd;    // 0x2C: This section's eventfd, in notify_pid's fd table
+};
+static_assert(sizeof(consumer_section) <= DEFAULT_CONSUMER_SECTION_SIZE);
+
+// ============================================================================
+// Section Accessors
+// ============================================================================
+
+inline producer_section* producer_get(void* header) {
+    auto* meta = static_cast<const metadata*>(header);
+    return reinterpret_cast<producer_section*>(static_cast<char*>(header) + meta->producer_offset);
+}
+
+inline consumer_section* consumer_get(void* header, uint8_t n) {
+    auto* meta = static_cast<const metadata*>(header);
+    return reinterpret_cast<consumer_section*>(static_cast<char*>(header) + consumer_offset(meta, n));
+}
+
+// Slowest attached consumer cursor, or `upper` if none is behind it
+inline uint64_t min_consumer_cursor(void* header, uint64_t upper) {
+    auto* meta = static_cast<const metadata*>(header);
+    uint64_t min_cursor = upper;
+    for (uint8_t i = 0; i < meta->max_consumers; ++i) {
+        auto* cons = consumer_get(header, i);
+        if (cons->pid.load(std::memory_order_acquire) == 0) continue;
+        min_cursor = std::min(min_cursor, cons->cursor.load(std::memory_order_acquire));
+    }
+    return min_cursor;
+}
+
+// Dependency mask bits naming consumer sections that exist in this ring
+inline uint64_t consumer_id_mask(const metadata* meta) {
+    return meta->max_consumers > MAX_DEPENDENCY_ID ? ~uint64_t{0} : (uint64_t{1} << meta->max_consumers) - 1;
+}
+
+// Highest readable sequence for a consumer depending on `depends`: the
+// producer cursor, capped by each attached upstream consumer's cursor.
+// Detached upstreams (pid 0) don't gate, as for the producer, and bits past
+// max_consumers are ignored.
+inline uint64_t read_barrier(void* header, uint64_t depends) {
+    uint64_t upper = producer_get(header)->cursor.load(std::memory_order_acquire);
+    depends &= consumer_id_mask(metadata_get(header));
+    for (; depends; depends &= depends - 1) {
+        auto* up = consumer_get(header, static_cast<uint8_t>(__builtin_ctzll(depends)));
+        if (up->pid.load(std::memory_order_acquire) == 0) continue;
+        upper = std::min(upper, up->cursor.load(std::memory_order_acquire));
+    }
+    return upper;
+}
+
+// Zero producer and consumer sections (call once after metadata_init)
+inline void sections_init(void* header) {
+    auto* meta = static_cast<const metadata*>(header);
+    auto* begin = static_cast<char*>(header) + meta->producer_offset;
+    auto* end = static_cast<char*>(header) + consumer_offset(meta, meta->max_consumers);
+    std::memset(begin, 0, static_cast<std::size_t>(end - begin));
+}
+
+// Split sequences [first, first + count) where they wrap at the end of the
+// data segment and invoke fn(uint64_t first, uint64_t run) for each run of
+// consecutive slots, so batch kernels can walk a run with a plain stride.
+template <typename F>
+inline void for_each_run(const metadata* meta, uint64_t first, uint64_t count, F&& fn) {
+    const uint64_t slots = slot_count(meta);
+    while (count > 0) {
+        uint64_t index = slot_offset(meta, first) >> meta->event_size_log2;
+        uint64_t run = std::min(count, slots - index);
+        fn(first, run);
+        first += run;
+        count -= run;
+    }
+}
+
+// ============================================================================
+// Prefetch
+// ============================================================================
+
+// Auto prefetch distance targets this many bytes ahead of the read position
+inline constexpr uint32_t PREFETCH_AUTO_BYTES = 16 * CACHE_LINE;
+
+// Upper bound on a configured prefetch distance (in slots)
+inline constexpr uint32_t PREFETCH_MAX_DISTANCE = 256;
+
+// set_prefetch_distance() value that disables prefetching
+inline constexpr uint32_t PREFETCH_OFF = UINT32_MAX;
+
+// Prefetch every cache line of a slot for reading
+inline void prefetch_slot(const void* slot, uint32_t bytes) {
+    const char* p = static_cast<const char*>(slot);
+    for (uint32_t off = 0; off < bytes; off += CACHE_LINE) {
+        __builtin_prefetch(p + off, 0, 3);
+    }
+}
+
+// ============================================================================
+// Event Copy
+// ============================================================================
+
+// Fixed-size copy kernel for the ring's events. copy_event<Log2> moves the
+// whole 1 << event_size_log2 slot, so it is only used when event_size is
+// itself a power of 2; other sizes get nullptr and callers memcpy event_size.
+inline event_copy_fn ring_copy_kernel(const metadata* meta) {
+    return is_power_of_2(meta->event_size) ? event_copy_kernel(meta->event_size_log2) : nullptr;
+}
+
+// ============================================================================
+// Producer
+// ============================================================================
+
+// Single producer over a mapped header and data segment.
+// Usage: try_claim() -> fill slot -> publish()
+// On rings created with METADATA_FLAG_NT_STORES, try_write() streams events of
+// NT_COPY_MIN_SIZE or more past the producer's caches and publish() fences first.
+class RingProducer {
+public:
+    RingProducer(void* header, void* data)
+        : header_(header),
+          meta_(metadata_get(header)),
+          prod_(producer_get(header)),
+          data_(static_cast<char*>(data)),
+          next_(prod_->cursor.load(std::memory_order_relaxed)),
+          gate_(0),
+          slots_(slot_count(meta_)),
+          stream_((meta_->flags & METADATA_FLAG_NT_STORES) != 0 &&
+                  meta_->event_size >= NT_COPY_MIN_SIZE),
+          copy_(ring_copy_kernel(meta_)) {}
+
+    // Pointer to the next free slot, nullptr if the slowest consumer is a full ring behind.
+    // With n > 1, reserves n consecutive slots (which may wrap) and returns the first.
+    auto try_claim(uint64_t n = 1) -> void* {
+        if (!has_capacity(n)) return nullptr;
+        return data_ + slot_offset(meta_, next_);
+    }
+
+    // Publish the n slots reserved by try_claim(n)
+    auto publish(uint64_t n = 1) -> void {
+        if (stream_) store_fence();
+        next_ += n;
+        prod_->cursor.store(next_, std::memory_order_release);
+    }
+
+    // Copy one event into the ring and publish it
+    auto try_write(const void* event, std::size_t size) -> bool {
+        void* slot = try_claim();
+        if (!slot) return false;
+        fill_slot(slot, event, size);
+        publish();
+        return true;
+    }
+
+    // Copy an event into a claimed slot (streaming or size-specialized as
+    // configured); publish() still makes it visible
+    auto fill_slot(void* slot, const void* event, std::size_t size) -> void {
+        size = std::min<std::size_t>(size, meta_->event_size);
+        if (stream_) {
+            copy_stream(slot, event, size);
+        } else if (copy_ && size == meta_->event_size) {
+            copy_(slot, event);
+        } else {
+            std::memcpy(slot, event, size);
+        }
+    }
+
+    // Slot address for any sequence (wraps via index_mask)
+    auto slot(uint64_t sequence) -> void* {
+        return data_ + slot_offset(meta_, sequence);
+    }
+
+    auto data() -> char* { return data_; }
+    auto sequence() const -> uint64_t { return next_; }
+    auto meta() const -> const metadata* { return meta_; }
+    auto streaming() const -> bool { return stream_; }
+
+private:
+    // Refresh the cached gate only when the cached value says we're full
+    auto has_capacity(uint64_t n) -> bool {
+        if (next_ + n - gate_ <= slots_) return true;
+        gate_ = min_consumer_cursor(header_, next_);
+        return next_ + n - gate_ <= slots_;
+    }
+
+    void* header_;
+    const metadata* meta_;
+    producer_section* prod_;
+    char* data_;
+    uint64_t next_;     // Local copy of prod_->cursor
+    uint64_t gate_;     // Cached min consumer cursor
+    uint64_t slots_;
+    bool stream_;       // Non-temporal slot writes
+    event_copy_fn copy_;  // nullptr unless event_size is a power of 2
+};
+
+// ============================================================================
+// Consumer
+// ============================================================================
+
+// Consumer bound to consumer section `id`.
+// Reads ahead of the cursor are prefetched; see set_prefetch_distance().
+//
+// Pipelines: a consumer may depend on other consumers of the same ring and
+// then sees an event only after every upstream consumer has advanced past
+// it, so stages (decode -> enrich -> journal) work on the slots in place
+// instead of copying between rings. The producer still gates on all of them.
+// An upstream that detaches stops gating its dependents; one that dies
+// attached stalls them until its section is detached (see dead_dependencies()).
+class RingConsumer {
+public:
+    RingConsumer(void* header, void* data, uint8_t id)
+        : header_(header),
+          meta_(metadata_get(header)),
+          prod_(producer_get(header)),
+          cons_(consumer_get(header, id)),
+          id_(id),
+          data_(static_cast<const char*>(data)),
+          next_(cons_->cursor.load(std::memory_order_relaxed)),
+          published_(next_),
+          depends_(cons_->depends.load(std::memory_order_acquire) & consumer_id_mask(meta_)),
+          prefetch_distance_(0),
+          copy_(ring_copy_kernel(meta_)) {}
+
+    // Register with the producer and join at its current cursor
+    // (or at the slowest upstream consumer, see set_dependencies())
+    auto attach() -> void {
+        next_ = barrier();
+        cons_->cursor.store(next_, std::memory_order_seq_cst);
+        cons_->pid.store(static_cast<uint32_t>(::getpid()), std::memory_order_seq_cst);
+        // Re-sync in case the producer published while we registered
+        next_ = barrier();
+        cons_->cursor.store(next_, std::memory_order_release);
+        published_ = next_;
+    }
+
+    // Read only events every consumer in `mask` (bit n = section n, n <= 63)
+    // has already advanced past. Stored in the consumer section, so the
+    // pipeline shape survives restarts; set before attach(). Returns false,
+    // leaving the dependencies unchanged, if `mask` names this consumer or a
+    // section past max_consumers.
+    auto set_dependencies(uint64_t mask) -> bool {
+        if ((mask & ~consumer_id_mask(meta_)) || (id_ <= MAX_DEPENDENCY_ID && (mask >> id_ & 1))) {
+            return false;
+        }
+        depends_ = mask;
+        cons_->depends.store(mask, std::memory_order_release);
+        published_ = next_;
+        return true;
+    }
+
+    auto dependencies() const -> uint64_t { return depends_; }
+
+    // Upstream consumers still attached whose process is gone. They hold this
+    // consumer back until their sections are detached or re-attached; a
+    // syscall per upstream, so call it when the consumer has been idle a while.
+    auto dead_dependencies() const -> uint64_t {
+        uint64_t dead = 0;
+        for (uint64_t m = depends_; m; m &= m - 1) {
+            auto id = static_cast<uint8_t>(__builtin_ctzll(m));
+            auto pid = static_cast<pid_t>(consumer_get(header_, id)->pid.load(std::memory_order_acquire));
+            if (pid != 0 && ::kill(pid, 0) != 0 && errno == ESRCH) dead |= uint64_t{1} << id;
+        }
+        return dead;
+    }
+
+    // Stop gating the producer
+    auto detach() -> void {
+        cons_->pid.store(0, std::memory_order_release);
+    }
+
+    // Number of published events not yet consumed
+    auto available() -> uint64_t {
+        if (published_ == next_) {
+            published_ = barrier();
+        }
+        return published_ - next_;
+    }
+
+    // Pointer to the next unread event, nullptr if none
+    auto peek() -> const void* {
+        return available() ? slot(next_) : nullptr;
+    }
+
+    // Release `n` events back to the producer
+    auto advance(uint64_t n = 1) -> void {
+        next_ += n;
+        cons_->cursor.store(next_, std::memory_order_release);
+    }
+
+    // Copy the next event into `out` and advance
+    auto try_read(void* out) -> bool {
+        const void* event = peek();
+        if (!event) return false;
+        if (copy_) {
+            copy_(out, event);
+        } else {
+            std::memcpy(out, event, meta_->event_size);
+        }
+        advance();
+        return true;
+    }
+
+    // Invoke fn(const void* event) for up to max_events events, then advance once.
+    // Slots ahead of the read position are prefetched so catch-up after a burst
+    // keeps several loads in flight instead of one demand miss per slot.
+    template <typename F>
+    auto poll(F&& fn, uint64_t max_events = UINT64_MAX) -> uint64_t {
+        uint64_t n = std::min(available(), max_events);
+        if (n == 0) return 0;
+
+        uint64_t dist = prefetch_distance(n);
+        for (uint64_t i = 1; i < dist; ++i) {
+            prefetch_slot(slot(next_ + i), meta_->event_size);
+        }
+        for (uint64_t i = 0; i < n; ++i) {
+            if (dist && i + dist < n) prefetch_slot(slot(next_ + i + dist), meta_->event_size);
+            fn(slot(next_ + i));
+        }
+        advance(n);
+        return n;
+    }
+
+    // Prefetch distance in slots (0 = auto-tune from lag and event size,
+    // PREFETCH_OFF = never prefetch)
+    auto set_prefetch_distance(uint32_t slots) -> void {
+        prefetch_distance_ = slots == PREFETCH_OFF ? PREFETCH_OFF : std::min(slots, PREFETCH_MAX_DISTANCE);
+    }
+
+    // Slot address for any sequence (wraps via index_mask)
+    auto slot(uint64_t sequence) const -> const void* {
+        return data_ + slot_offset(meta_, sequence);
+    }
+
+    auto data() const -> const char* { return data_; }
+    auto sequence() const -> uint64_t { return next_; }
+    auto meta() const -> const metadata* { return meta_; }
+
+private:
+    // Highest readable sequence: producer cursor, capped by upstream consumers
+    auto barrier() const -> uint64_t {
+        if (!depends_) return prod_->cursor.load(std::memory_order_acquire);
+        return read_barrier(header_, depends_);
+    }
+
+    // Auto mode: PREFETCH_AUTO_BYTES ahead, never past the published lag
+    auto prefetch_distance(uint64_t lag) const -> uint64_t {
+        if (lag < 2 || prefetch_distance_ == PREFETCH_OFF) return 0;
+        uint64_t dist = prefetch_distance_;
+        if (dist == 0) {
+            dist = std::max<uint64_t>(1, PREFETCH_AUTO_BYTES >> meta_->event_size_log2);
+        }
+        return std::min(dist, lag - 1);
+    }
+
+    void* header_;
+    const metadata* meta_;
+    producer_section* prod_;
+    consumer_section* cons_;
+    uint8_t id_;
+    const char* data_;
+    uint64_t next_;                 // Local copy of cons_->cursor
+    uint64_t published_;            // Cached barrier (producer / upstream cursors)
+    uint64_t depends_;              // Upstream consumer mask
+    uint32_t prefetch_distance_;
+    event_copy_fn copy_;            // nullptr unless event_size is a power of 2
+};
+
+} // namespace hftshm
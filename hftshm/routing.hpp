@@ -0,0 +1,301 @@
+#pragma once
+
+#include <atomic>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "layout.hpp"
+#include "ring.hpp"
+
+namespace hftshm {
+
+// ============================================================================
+// Route Segment Layout (<name>.rt)
+// ============================================================================
+
+// Magic number: "HFTROUTE" in little-endian
+inline constexpr uint64_t ROUTE_MAGIC = 0x4554554F52544648ULL;
+
+// Interest bits per consumer unless chosen at route_init()
+inline constexpr uint32_t ROUTE_DEFAULT_KEY_SPACE = 8192;
+inline constexpr uint32_t ROUTE_MAX_KEY_SPACE = 1u << 20;
+
+struct alignas(CACHE_LINE) route_segment_header {
+    uint64_t magic;                   // 0x00: ROUTE_MAGIC
+    uint32_t key_space;               // 0x08: Interest bits per consumer (power of 2)
+    uint32_t reserved;                // 0x0C
+};
+
+// One route queue per consumer section. The producer appends the sequence of
+// every event whose key is in the consumer's interest bitmap, so a routed
+// consumer touches only its own queue and the slots it asked for.
+//
+// Queue capacity equals the ring's slot count: a routed consumer's cursor
+// gates the producer, so at most slot_count routed events are ever pending.
+struct alignas(CACHE_LINE) route_queue {
+    std::atomic<uint64_t> head;       // 0x00: Entries [0, head) have been written
+    // Followed by uint64_t entries[slot_count] (sequence numbers), then the
+    // interest bitmap: key_space bits, read by the producer, written on (un)subscribe
+};
+
+// Map a key to its interest bit. Keys below key_space have a bit of their
+// own; larger keys share bits, and their consumers must check each event's key.
+inline constexpr uint32_t interest_bit(uint32_t key, uint32_t key_space) {
+    return key & (key_space - 1);
+}
+
+// Size of one consumer's route queue and interest bitmap (cache-line multiple)
+inline uint32_t route_queue_size(const metadata* meta, uint32_t key_space) {
+    uint32_t raw = CACHE_LINE + slot_count(meta) * 8u + key_space / 8;
+    return ((raw + CACHE_LINE - 1) / CACHE_LINE) * CACHE_LINE;
+}
+
+// Calculate route segment size (page-aligned)
+inline uint32_t route_segment_size(const metadata* meta, uint32_t key_space = ROUTE_DEFAULT_KEY_SPACE) {
+    uint32_t raw = sizeof(route_segment_header) + meta->max_consumers * route_queue_size(meta, key_space);
+    return ((raw + PAGE_SIZE - 1) / PAGE_SIZE) * PAGE_SIZE;
+}
+
+// Size key_space to the number of distinct keys (e.g. instrument ids) so
+// routing is exact; key_space must be a power of 2 from 64 to ROUTE_MAX_KEY_SPACE.
+inline bool route_init(void* routes, const metadata* meta, uint32_t key_space = ROUTE_DEFAULT_KEY_SPACE) {
+    if (!is_power_of_2(key_space) || key_space < 64 || key_space > ROUTE_MAX_KEY_SPACE) return false;
+    auto* hdr = static_cast<route_segment_header*>(routes);
+    std::memset(routes, 0, route_segment_size(meta, key_space));
+    hdr->key_space = key_space;
+    std::atomic_thread_fence(std::memory_order_release);
+    hdr->magic = ROUTE_MAGIC;
+    return true;
+}
+
+inline bool route_validate(const void* routes) {
+    return static_cast<const route_segment_header*>(routes)->magic == ROUTE_MAGIC;
+}
+
+inline uint32_t route_key_space(const void* routes) {
+    return static_cast<const route_segment_header*>(routes)->key_space;
+}
+
+inline route_queue* route_queue_get(void* routes, const metadata* meta, uint8_t n) {
+    return reinterpret_cast<route_queue*>(static_cast<char*>(routes) + sizeof(route_segment_header) +
+                                          n * route_queue_size(meta, route_key_space(routes)));
+}
+
+inline uint64_t* route_entries(route_queue* queue) {
+    return reinterpret_cast<uint64_t*>(reinterpret_cast<char*>(queue) + CACHE_LINE);
+}
+
+inline std::atomic<uint64_t>* route_interest(route_queue* queue, const metadata* meta) {
+    return reinterpret_cast<std::atomic<uint64_t>*>(route_entries(queue) + slot_count(meta));
+}
+
+// ============================================================================
+// Routed Producer
+// ============================================================================
+
+// RingProducer that also appends each keyed event to the route queue of every
+// routed consumer interested in the key. Interest bitmaps are snapshotted
+// locally and re-read only when producer_section::route_epoch changes; the
+// epoch is checked on every publish, so a subscription reaches the producer
+// by its next publish() (an event already being published may miss it).
+class RoutedProducer {
+public:
+    RoutedProducer(void* header, void* data, void* routes)
+        : ring_(header, data),
+          header_(header),
+          routes_(routes),
+          meta_(metadata_get(header)),
+          prod_(producer_get(header)),
+          mask_(slot_count(meta_) - 1),
+          key_space_(route_key_space(routes)),
+          words_(key_space_ / 64),
+          epoch_(prod_->route_epoch.load(std::memory_order_acquire)) {
+        targets_.reserve(meta_->max_consumers);
+        interest_.reserve(std::size_t{meta_->max_consumers} * words_);
+        refresh();
+    }
+
+    auto try_claim() -> void* { return ring_.try_claim(); }
+
+    // Publish the claimed slot, routing it by `key`
+    auto publish(uint32_t key) -> void {
+        uint32_t epoch = prod_->route_epoch.load(std::memory_order_acquire);
+        if (epoch != epoch_) {
+            epoch_ = epoch;
+            refresh();
+        }
+
+        const uint32_t bit = interest_bit(key, key_space_);
+        const uint64_t seq = ring_.sequence();
+        for (auto& t : targets_) {
+            if (!(t.interest[bit / 64] & (1ULL << (bit % 64)))) continue;
+            route_entries(t.queue)[t.head & mask_] = seq;
+            t.queue->head.store(++t.head, std::memory_order_release);
+        }
+        ring_.publish();
+    }
+
+    auto try_write(const void* event, std::size_t size, uint32_t key) -> bool {
+        void* slot = try_claim();
+        if (!slot) return false;
+        ring_.fill_slot(slot, event, size);
+        publish(key);
+        return true;
+    }
+
+    auto ring() -> RingProducer& { return ring_; }
+
+private:
+    struct Target {
+        route_queue* queue;
+        uint64_t head;                      // Local copy of queue->head
+        const uint64_t* interest;           // Snapshot in interest_
+    };
+
+    // Snapshot attached routed consumers and their interest bitmaps
+    auto refresh() -> void {
+        targets_.clear();
+        interest_.clear();
+        for (uint8_t i = 0; i < meta_->max_consumers; ++i) {
+            auto* cons = consumer_get(header_, i);
+            if (cons->pid.load(std::memory_order_acquire) == 0) continue;
+            if (!(cons->flags.load(std::memory_order_acquire) & CONSUMER_FLAG_ROUTED)) continue;
+
+            route_queue* queue = route_queue_get(routes_, meta_, i);
+            std::atomic<uint64_t>* bits = route_interest(queue, meta_);
+            for (uint32_t w = 0; w < words_; ++w) {
+                interest_.push_back(bits[w].load(std::memory_order_relaxed));
+            }
+            targets_.push_back({queue, queue->head.load(std::memory_order_relaxed), nullptr});
+        }
+        for (std::size_t t = 0; t < targets_.size(); ++t) {
+            targets_[t].interest = interest_.data() + t * words_;
+        }
+    }
+
+    RingProducer ring_;
+    void* header_;
+    void* routes_;
+    const metadata* meta_;
+    producer_section* prod_;
+    uint64_t mask_;
+    uint32_t key_space_;
+    uint32_t words_;                        // Interest words per consumer
+    uint32_t epoch_;
+    std::vector<Target> targets_;
+    std::vector<uint64_t> interest_;        // Bitmaps of targets_, words_ each
+};
+
+// ============================================================================
+// Routed Consumer
+// ============================================================================
+
+// Consumer that reads only the events the producer routed to it, then moves its
+// gating cursor straight to the producer cursor past everything it skipped.
+class RoutedConsumer {
+public:
+    RoutedConsumer(void* header, void* data, void* routes, uint8_t id)
+        : ring_(header, data, id),
+          prod_(producer_get(header)),
+          cons_(consumer_get(header, id)),
+          queue_(route_queue_get(routes, metadata_get(header), id)),
+          entries_(route_entries(queue_)),
+          interest_(route_interest(queue_, metadata_get(header))),
+          key_space_(route_key_space(routes)),
+          mask_(slot_count(metadata_get(header)) - 1),
+          tail_(queue_->head.load(std::memory_order_acquire)) {}
+
+    // Join at the producer cursor and start receiving routed events
+    auto attach() -> void {
+        ring_.attach();
+        tail_ = queue_->head.load(std::memory_order_acquire);
+        cons_->flags.fetch_or(CONSUMER_FLAG_ROUTED, std::memory_order_release);
+        bump_epoch();
+    }
+
+    auto detach() -> void {
+        cons_->flags.fetch_and(~CONSUMER_FLAG_ROUTED, std::memory_order_release);
+        ring_.detach();
+        bump_epoch();
+    }
+
+    // Route events with `key` here from the producer's next publish()
+    auto subscribe(uint32_t key) -> void {
+        set_bit(interest_bit(key, key_space_));
+        bump_epoch();
+    }
+
+    // Subscribe to every key in [lo, hi]; a range as wide as the key space
+    // sets every bit
+    auto subscribe_range(uint32_t lo, uint32_t hi) -> void {
+        if (uint64_t{hi} - lo + 1 >= key_space_) {
+            for (uint32_t w = 0; w < key_space_ / 64; ++w) {
+                interest_[w].store(~uint64_t{0}, std::memory_order_relaxed);
+            }
+        } else {
+            for (uint64_t k = lo; k <= hi; ++k) {
+                set_bit(interest_bit(static_cast<uint32_t>(k), key_space_));
+            }
+        }
+        bump_epoch();
+    }
+
+    auto unsubscribe_all() -> void {
+        for (uint32_t w = 0; w < key_space_ / 64; ++w) {
+            interest_[w].store(0, std::memory_order_relaxed);
+        }
+        bump_epoch();
+    }
+
+    // Invoke fn(const void* event) for up to max_events routed events
+    template <typename F>
+    auto poll(F&& fn, uint64_t max_events = UINT64_MAX) -> uint64_t {
+        const uint64_t published = ring_.sequence() + ring_.available();
+        const uint64_t head = queue_->head.load(std::memory_order_acquire);
+
+        uint64_t n = 0;
+        uint64_t release = published;
+        while (tail_ != head) {
+            uint64_t seq = entries_[tail_ & mask_];
+            if (seq >= published) break;     // Routed but not yet published
+            if (n == max_events) {
+                release = seq;
+                break;
+            }
+            if (tail_ + 1 != head) {
+                prefetch_slot(ring_.slot(entries_[(tail_ + 1) & mask_]), ring_.meta()->event_size);
+            }
+            fn(ring_.slot(seq));
+            ++tail_;
+            ++n;
+        }
+        if (release > ring_.sequence()) ring_.advance(release - ring_.sequence());
+        return n;
+    }
+
+    auto ring() -> RingConsumer& { return ring_; }
+
+private:
+    auto set_bit(uint32_t bit) -> void {
+        interest_[bit / 64].fetch_or(1ULL << (bit % 64), std::memory_order_relaxed);
+    }
+
+    auto bump_epoch() -> void {
+        prod_->route_epoch.fetch_add(1, std::memory_order_release);
+    }
+
+    RingConsumer ring_;
+    producer_section* prod_;
+    consumer_section* cons_;
+    route_queue* queue_;
+    const uint64_t* entries_;
+    std::atomic<uint64_t>* interest_;
+    uint32_t key_space_;
+    uint64_t mask_;
+    uint64_t tail_;         // Next route entry to read
+};
+
+} // namespace hftshm
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "layout.hpp"
+#include "wait.hpp"
+
+namespace hftshm {
+
+// ============================================================================
+// Seqlock Primitives
+// ============================================================================
+
+// Single-writer sequence lock over any bytes next to a std::atomic<uint32_t>.
+// The sequence is odd while the writer updates. Fences follow the standard
+// seqlock mapping (Boehm): the writer's release fence orders the odd store
+// before the data stores, the reader's acquire fence orders its data loads
+// before the re-check. On x86 both fences compile to nothing; on ARM they
+// are dmb barriers. Use these directly for runtime-sized data; prefer
+// seqlock<T> when the type is known.
+
+// Default read attempts before try_read() gives up
+inline constexpr uint32_t SEQLOCK_READ_ATTEMPTS = 1024;
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+// Writer: returns the sequence to pass to seqlock_write_end()
+inline uint32_t seqlock_write_begin(std::atomic<uint32_t>& seq) {
+    uint32_t s = seq.load(std::memory_order_relaxed) + 1;
+    seq.store(s, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    return s;
+}
+
+inline void seqlock_write_end(std::atomic<uint32_t>& seq, uint32_t s) {
+    seq.store(s + 1, std::memory_order_release);
+}
+
+// Reader: the sequence to validate against, or an odd value while a write is in flight
+inline uint32_t seqlock_read_begin(const std::atomic<uint32_t>& seq) {
+    return seq.load(std::memory_order_acquire);
+}
+
+// True if data read since seqlock_read_begin() returned `s` must be discarded
+inline bool seqlock_read_retry(const std::atomic<uint32_t>& seq, uint32_t s) {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return (s & 1) || seq.load(std::memory_order_relaxed) != s;
+}
+
+// Copy `size` bytes guarded by `seq` into `out`. Gives up after max_attempts
+// torn or in-flight reads; the retry count is added to *retries if given.
+inline bool seqlock_copy(const std::atomic<uint32_t>& seq, void* out, const void* src, std::size_t size,
+                         uint32_t max_attempts = SEQLOCK_READ_ATTEMPTS, uint32_t* retries = nullptr) {
+    for (uint32_t attempt = 0; attempt < max_attempts; ++attempt) {
+        uint32_t s = seqlock_read_begin(seq);
+        if (!(s & 1)) {
+            std::memcpy(out, src, size);
+            if (!seqlock_read_retry(seq, s)) {
+                if (retries) *retries += attempt;
+                return true;
+            }
+        }
+        cpu_relax();
+    }
+    if (retries) *retries += max_attempts;
+    return false;
+}
+
+// ============================================================================
+// Seqlock<T>
+// ============================================================================
+
+// Trivially copyable value plus its sequence, on its own cache line(s).
+// Place directly in a segment; zero-initialized memory is a valid seqlock.
+template <typename T>
+struct alignas(CACHE_LINE) seqlock {
+    static_assert(std::is_trivially_copyable_v<T>, "seqlock<T> requires a trivially copyable T");
+
+    std::atomic<uint32_t> seq;
+    T value;
+
+    // Writer: replace the value
+    auto store(const T& v) -> void {
+        uint32_t s = seqlock_write_begin(seq);
+        std::memcpy(static_cast<void*>(&value), &v, sizeof(T));
+        seqlock_write_end(seq, s);
+    }
+
+    // Writer: modify in place with fn(T&)
+    template <typename F>
+    auto update(F&& fn) -> void {
+        uint32_t s = seqlock_write_begin(seq);
+        fn(value);
+        seqlock_write_end(seq, s);
+    }
+
+    // Reader: bounded; false if no consistent copy within max_attempts
+    auto try_load(T& out, uint32_t max_attempts = SEQLOCK_READ_ATTEMPTS, uint32_t* retries = nullptr) const -> bool {
+        return seqlock_copy(seq, &out, &value, sizeof(T), max_attempts, retries);
+    }
+
+    // Reader: retries until consistent
+    auto load() const -> T {
+        T out;
+        while (!try_load(out)) {}
+        return out;
+    }
+
+    // Bumped by 2 per completed write; changes mean the value changed
+    auto version() const -> uint32_t { return seq.load(std::memory_order_acquire); }
+};
+
+} // namespace hftshm
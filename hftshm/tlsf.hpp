@@ -0,0 +1,422 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include "layout.hpp"
+#include "wait.hpp"
+
+namespace hftshm {
+
+// ============================================================================
+// TLSF Constants
+// ============================================================================
+
+// Two-level segregated fit: the first level splits sizes by power of 2, the
+// second level splits each power-of-2 range linearly into TLSF_SL_COUNT lists.
+// Both levels have a bitmap, so finding a fitting free list is two bit scans.
+inline constexpr uint32_t TLSF_ALIGN_LOG2 = 4;
+inline constexpr uint32_t TLSF_ALIGN = 1u << TLSF_ALIGN_LOG2;            // 16 bytes
+inline constexpr uint32_t TLSF_SL_LOG2 = 4;
+inline constexpr uint32_t TLSF_SL_COUNT = 1u << TLSF_SL_LOG2;            // 16 lists per level
+inline constexpr uint32_t TLSF_FL_SHIFT = TLSF_SL_LOG2 + TLSF_ALIGN_LOG2;
+inline constexpr uint32_t TLSF_SMALL_BLOCK = 1u << TLSF_FL_SHIFT;        // 256 bytes
+inline constexpr uint32_t TLSF_FL_COUNT = 32 - TLSF_FL_SHIFT + 1;
+inline constexpr uint32_t TLSF_MIN_PAYLOAD = TLSF_ALIGN;
+
+// Offsets are relative to the segment start; offset 0 is the header, so 0 is null
+inline constexpr uint32_t TLSF_NULL = 0;
+
+// Magic number: "HFTTLSF\x01" in little-endian
+inline constexpr uint64_t TLSF_MAGIC = 0x01465353544C4648ULL;
+
+// Block size flags (payload sizes are TLSF_ALIGN multiples, so low bits are free)
+inline constexpr uint32_t TLSF_BLOCK_FREE = 0x1;
+inline constexpr uint32_t TLSF_BLOCK_PREV_FREE = 0x2;
+inline constexpr uint32_t TLSF_SIZE_MASK = ~(TLSF_ALIGN - 1);
+
+// ============================================================================
+// TLSF Segment Layout
+// ============================================================================
+
+struct alignas(CACHE_LINE) tlsf_header {
+    uint64_t magic;                                   // 0x00: TLSF_MAGIC
+    uint32_t size;                                    // 0x08: Segment size
+    uint32_t first_block;                             // 0x0C: Offset of first block
+    std::atomic<uint32_t> lock;                       // 0x10: Holder PID (TlsfSharedAllocator)
+    uint32_t fl_bitmap;                               // 0x14: Non-empty first levels
+    uint32_t sl_bitmap[TLSF_FL_COUNT];                // Non-empty lists per first level
+    uint32_t heads[TLSF_FL_COUNT][TLSF_SL_COUNT];     // Free list heads
+
+    // Own cache line, read on every shared alloc/free and written at most once
+    alignas(CACHE_LINE) std::atomic<uint32_t> poisoned;  // Nonzero once a writer died holding the lock
+};
+
+// Block header; the payload follows at +sizeof(tlsf_block)
+struct tlsf_block {
+    uint32_t prev_phys;               // 0x00: Offset of the previous physical block
+    uint32_t size;                    // 0x04: Payload bytes | TLSF_BLOCK_* flags
+    uint32_t next_free;               // 0x08: Free list links (valid while free)
+    uint32_t prev_free;               // 0x0C
+};
+inline constexpr uint32_t TLSF_BLOCK_HEADER_SIZE = sizeof(tlsf_block);
+static_assert(TLSF_BLOCK_HEADER_SIZE == TLSF_ALIGN);
+
+// ============================================================================
+// TLSF Allocator (single writer)
+// ============================================================================
+
+// O(1) allocate/free over a segment, no system calls. Only the writer touches
+// allocator state, so any process may read allocated blocks lock-free through
+// their offsets. One writer at a time; see TlsfSharedAllocator for several.
+class TlsfAllocator {
+public:
+    explicit TlsfAllocator(void* pool)
+        : base_(static_cast<char*>(pool)),
+          hdr_(static_cast<tlsf_header*>(pool)) {}
+
+    // Format a segment as one free block
+    static auto init(void* pool, uint32_t size) -> bool {
+        uint32_t first = align_up(sizeof(tlsf_header));
+        if (size < first + 3 * TLSF_BLOCK_HEADER_SIZE + TLSF_MIN_PAYLOAD) return false;
+
+        auto* hdr = static_cast<tlsf_header*>(pool);
+        std::memset(static_cast<void*>(hdr), 0, sizeof(tlsf_header));
+        hdr->size = size;
+        hdr->first_block = first;
+
+        TlsfAllocator a(pool);
+        uint32_t payload = (size - first - 2 * TLSF_BLOCK_HEADER_SIZE) & TLSF_SIZE_MASK;
+        tlsf_block* b = a.block(first);
+        *b = {TLSF_NULL, payload | TLSF_BLOCK_FREE, TLSF_NULL, TLSF_NULL};
+
+        // Zero-size used sentinel stops coalescing at the end of the segment
+        tlsf_block* end = a.block(first + TLSF_BLOCK_HEADER_SIZE + payload);
+        *end = {first, TLSF_BLOCK_PREV_FREE, TLSF_NULL, TLSF_NULL};
+
+        a.insert_free(first);
+        hdr->magic = TLSF_MAGIC;
+        return true;
+    }
+
+    auto valid() const -> bool { return hdr_->magic == TLSF_MAGIC; }
+
+    // Free lists may be corrupt (a TlsfSharedAllocator writer died mid-update);
+    // re-create the segment with init()
+    auto poisoned() const -> bool { return hdr_->poisoned.load(std::memory_order_acquire) != 0; }
+
+    // Allocate `size` bytes; returns the payload offset or TLSF_NULL
+    auto alloc(uint32_t size) -> uint32_t {
+        if (size == 0 || size > (1u << 31)) return TLSF_NULL;
+        uint32_t adj = align_up(size < TLSF_MIN_PAYLOAD ? TLSF_MIN_PAYLOAD : size);
+
+        uint32_t fl, sl;
+        mapping_search(adj, fl, sl);
+        uint32_t off = find_suitable(fl, sl);
+        if (off == TLSF_NULL) return TLSF_NULL;
+        remove_free(off);
+
+        tlsf_block* b = block(off);
+        uint32_t bsize = b->size & TLSF_SIZE_MASK;
+        if (bsize >= adj + TLSF_BLOCK_HEADER_SIZE + TLSF_MIN_PAYLOAD) {
+            // Split; the remainder stays free and the next block keeps PREV_FREE
+            uint32_t rest = off + TLSF_BLOCK_HEADER_SIZE + adj;
+            tlsf_block* r = block(rest);
+            *r = {off, (bsize - adj - TLSF_BLOCK_HEADER_SIZE) | TLSF_BLOCK_FREE, TLSF_NULL, TLSF_NULL};
+            block(next_phys(rest))->prev_phys = rest;
+            insert_free(rest);
+            b->size = adj | (b->size & TLSF_BLOCK_PREV_FREE);
+        } else {
+            block(next_phys(off))->size &= ~TLSF_BLOCK_PREV_FREE;
+            b->size &= ~TLSF_BLOCK_FREE;
+        }
+        return off + TLSF_BLOCK_HEADER_SIZE;
+    }
+
+    // Free a payload offset returned by alloc()
+    auto free(uint32_t offset) -> void {
+        if (offset == TLSF_NULL) return;
+        uint32_t off = offset - TLSF_BLOCK_HEADER_SIZE;
+        tlsf_block* b = block(off);
+        b->size |= TLSF_BLOCK_FREE;
+
+        if (b->size & TLSF_BLOCK_PREV_FREE) {
+            uint32_t prev = b->prev_phys;
+            remove_free(prev);
+            block(prev)->size += TLSF_BLOCK_HEADER_SIZE + (b->size & TLSF_SIZE_MASK);
+            off = prev;
+            b = block(off);
+        }
+
+        uint32_t next = next_phys(off);
+        if (block(next)->size & TLSF_BLOCK_FREE) {
+            remove_free(next);
+            b->size += TLSF_BLOCK_HEADER_SIZE + (block(next)->size & TLSF_SIZE_MASK);
+            next = next_phys(off);
+        }
+
+        tlsf_block* n = block(next);
+        n->prev_phys = off;
+        n->size |= TLSF_BLOCK_PREV_FREE;
+        insert_free(off);
+    }
+
+    // Usable payload bytes of an allocated offset
+    auto usable_size(uint32_t offset) const -> uint32_t {
+        return block(offset - TLSF_BLOCK_HEADER_SIZE)->size & TLSF_SIZE_MASK;
+    }
+
+    auto ptr(uint32_t offset) const -> void* { return offset ? base_ + offset : nullptr; }
+    auto offset(const void* p) const -> uint32_t {
+        return p ? static_cast<uint32_t>(static_cast<const char*>(p) - base_) : TLSF_NULL;
+    }
+
+    auto header() const -> tlsf_header* { return hdr_; }
+
+private:
+    static constexpr auto align_up(std::size_t n) -> uint32_t {
+        return static_cast<uint32_t>((n + TLSF_ALIGN - 1) & ~std::size_t{TLSF_ALIGN - 1});
+    }
+
+    static auto fls(uint32_t x) -> uint32_t { return 31 - static_cast<uint32_t>(__builtin_clz(x)); }
+    static auto ffs(uint32_t x) -> uint32_t { return static_cast<uint32_t>(__builtin_ctz(x)); }
+
+    static auto mapping_insert(uint32_t size, uint32_t& fl, uint32_t& sl) -> void {
+        if (size < TLSF_SMALL_BLOCK) {
+            fl = 0;
+            sl = size >> TLSF_ALIGN_LOG2;
+        } else {
+            uint32_t f = fls(size);
+            sl = (size >> (f - TLSF_SL_LOG2)) ^ TLSF_SL_COUNT;
+            fl = f - (TLSF_FL_SHIFT - 1);
+        }
+    }
+
+    // Round up to the next list boundary so any block in the list fits
+    static auto mapping_search(uint32_t size, uint32_t& fl, uint32_t& sl) -> void {
+        if (size >= TLSF_SMALL_BLOCK) {
+            size += (1u << (fls(size) - TLSF_SL_LOG2)) - 1;
+        }
+        mapping_insert(size, fl, sl);
+    }
+
+    auto find_suitable(uint32_t fl, uint32_t sl) const -> uint32_t {
+        if (fl >= TLSF_FL_COUNT) return TLSF_NULL;
+        uint32_t sl_map = hdr_->sl_bitmap[fl] & (~0u << sl);
+        if (!sl_map) {
+            uint32_t fl_map = fl + 1 < 32 ? hdr_->fl_bitmap & (~0u << (fl + 1)) : 0;
+            if (!fl_map) return TLSF_NULL;
+            fl = ffs(fl_map);
+            sl_map = hdr_->sl_bitmap[fl];
+        }
+        return hdr_->heads[fl][ffs(sl_map)];
+    }
+
+    auto insert_free(uint32_t off) -> void {
+        uint32_t fl, sl;
+        mapping_insert(block(off)->size & TLSF_SIZE_MASK, fl, sl);
+        uint32_t head = hdr_->heads[fl][sl];
+        tlsf_block* b = block(off);
+        b->next_free = head;
+        b->prev_free = TLSF_NULL;
+        if (head) block(head)->prev_free = off;
+        hdr_->heads[fl][sl] = off;
+        hdr_->fl_bitmap |= 1u << fl;
+        hdr_->sl_bitmap[fl] |= 1u << sl;
+    }
+
+    auto remove_free(uint32_t off) -> void {
+        uint32_t fl, sl;
+        mapping_insert(block(off)->size & TLSF_SIZE_MASK, fl, sl);
+        tlsf_block* b = block(off);
+        if (b->next_free) block(b->next_free)->prev_free = b->prev_free;
+        if (b->prev_free) {
+            block(b->prev_free)->next_free = b->next_free;
+        } else {
+            hdr_->heads[fl][sl] = b->next_free;
+            if (!b->next_free) {
+                hdr_->sl_bitmap[fl] &= ~(1u << sl);
+                if (!hdr_->sl_bitmap[fl]) hdr_->fl_bitmap &= ~(1u << fl);
+            }
+        }
+    }
+
+    auto block(uint32_t off) const -> tlsf_block* {
+        return reinterpret_cast<tlsf_block*>(base_ + off);
+    }
+
+    auto next_phys(uint32_t off) const -> uint32_t {
+        return off + TLSF_BLOCK_HEADER_SIZE + (block(off)->size & TLSF_SIZE_MASK);
+    }
+
+    char* base_;
+    tlsf_header* hdr_;
+};
+
+// ============================================================================
+// TLSF Shared Allocator (multiple writers)
+// ============================================================================
+
+// Small blocks cached per allocator object (one per process or thread)
+inline constexpr uint32_t TLSF_CACHE_MAX_SIZE = 256;
+inline constexpr uint32_t TLSF_CACHE_CLASSES = TLSF_CACHE_MAX_SIZE / TLSF_ALIGN;
+inline constexpr uint32_t TLSF_CACHE_DEPTH = 32;
+inline constexpr uint32_t TLSF_CACHE_BATCH = TLSF_CACHE_DEPTH / 2;
+
+// Spins on a held lock before yielding and checking whether the holder is alive
+inline constexpr uint32_t TLSF_LOCK_SPINS = 1024;
+
+// TLSF shared by several writer processes. The segment is guarded by a spin
+// lock in tlsf_header; blocks up to TLSF_CACHE_MAX_SIZE come from a local cache
+// refilled and drained TLSF_CACHE_BATCH blocks per lock acquisition, so the
+// common small alloc and sized free take no lock at all. Not thread-safe: use
+// one object per thread.
+//
+// A writer that dies holding the lock is detected by PID and the lock is taken
+// over, so the other writers never hang. Its free lists may have been left
+// mid-update, so the takeover also poisons the segment: from then on alloc()
+// returns TLSF_NULL, frees are dropped, and poisoned() tells callers to
+// re-create the segment.
+class TlsfSharedAllocator {
+public:
+    explicit TlsfSharedAllocator(void* pool)
+        : tlsf_(pool),
+          pid_(static_cast<uint32_t>(::getpid())) {}
+
+    TlsfSharedAllocator(const TlsfSharedAllocator&) = delete;
+    auto operator=(const TlsfSharedAllocator&) -> TlsfSharedAllocator& = delete;
+
+    ~TlsfSharedAllocator() { flush(); }
+
+    auto alloc(uint32_t size) -> uint32_t {
+        if (poisoned()) return TLSF_NULL;
+        if (size == 0 || size > TLSF_CACHE_MAX_SIZE) {
+            Guard g(*this);
+            return poisoned() ? TLSF_NULL : tlsf_.alloc(size);
+        }
+        Cache& c = caches_[class_of(size)];
+        if (c.count == 0) refill(c, class_size(class_of(size)));
+        return c.count ? c.blocks[--c.count] : TLSF_NULL;
+    }
+
+    // Free a block. Its header is shared with neighbouring blocks' updates,
+    // so the size is read under the lock; prefer free(offset, size) when the
+    // allocation size is known.
+    auto free(uint32_t offset) -> void {
+        if (offset == TLSF_NULL) return;
+        Guard g(*this);
+        if (poisoned()) return;
+        uint32_t size = tlsf_.usable_size(offset);
+        if (size > TLSF_CACHE_MAX_SIZE || class_size(class_of(size)) != size) {
+            tlsf_.free(offset);
+            return;
+        }
+        Cache& c = caches_[class_of(size)];
+        if (c.count == TLSF_CACHE_DEPTH) drain_locked(c, TLSF_CACHE_BATCH);
+        c.blocks[c.count++] = offset;
+    }
+
+    // Free a block allocated with alloc(size); small sizes return to the
+    // local cache without taking the lock
+    auto free(uint32_t offset, uint32_t size) -> void {
+        if (offset == TLSF_NULL || poisoned()) return;
+        if (size == 0 || size > TLSF_CACHE_MAX_SIZE) {
+            Guard g(*this);
+            if (!poisoned()) tlsf_.free(offset);
+            return;
+        }
+        Cache& c = caches_[class_of(size)];
+        if (c.count == TLSF_CACHE_DEPTH) drain(c, TLSF_CACHE_BATCH);
+        c.blocks[c.count++] = offset;
+    }
+
+    // Return every cached block to the shared segment
+    auto flush() -> void {
+        for (auto& c : caches_) {
+            if (c.count) drain(c, c.count);
+        }
+    }
+
+    // A writer died holding the lock; the segment must be re-created
+    auto poisoned() const -> bool { return tlsf_.poisoned(); }
+
+    auto ptr(uint32_t offset) const -> void* { return tlsf_.ptr(offset); }
+    auto offset(const void* p) const -> uint32_t { return tlsf_.offset(p); }
+
+private:
+    struct Cache {
+        uint32_t count = 0;
+        uint32_t blocks[TLSF_CACHE_DEPTH];
+    };
+
+    struct Guard {
+        explicit Guard(TlsfSharedAllocator& a) : a_(a) { a_.lock(); }
+        ~Guard() { a_.unlock(); }
+        TlsfSharedAllocator& a_;
+    };
+
+    static auto class_of(uint32_t size) -> uint32_t { return (size - 1) >> TLSF_ALIGN_LOG2; }
+    static auto class_size(uint32_t cls) -> uint32_t { return (cls + 1) << TLSF_ALIGN_LOG2; }
+
+    // Spin, then yield; past TLSF_LOCK_SPINS take over a lock whose holder
+    // died, poisoning the segment
+    auto lock() -> void {
+        auto& l = tlsf_.header()->lock;
+        const YieldingWait wait{TLSF_LOCK_SPINS};
+        for (uint32_t attempt = 0;; ++attempt) {
+            uint32_t holder = l.load(std::memory_order_relaxed);
+            if (holder == 0 || (attempt >= TLSF_LOCK_SPINS && (attempt & 63) == 0 && holder_dead(holder))) {
+                uint32_t dead = holder;
+                if (l.compare_exchange_weak(holder, pid_, std::memory_order_acquire)) {
+                    if (dead != 0) tlsf_.header()->poisoned.store(1, std::memory_order_release);
+                    return;
+                }
+            }
+            wait.idle(attempt);
+        }
+    }
+
+    static auto holder_dead(uint32_t pid) -> bool {
+        return ::kill(static_cast<pid_t>(pid), 0) != 0 && errno == ESRCH;
+    }
+
+    auto unlock() -> void {
+        tlsf_.header()->lock.store(0, std::memory_order_release);
+    }
+
+    auto refill(Cache& c, uint32_t size) -> void {
+        Guard g(*this);
+        if (poisoned()) return;
+        while (c.count < TLSF_CACHE_BATCH) {
+            uint32_t off = tlsf_.alloc(size);
+            if (off == TLSF_NULL) break;
+            c.blocks[c.count++] = off;
+        }
+    }
+
+    auto drain(Cache& c, uint32_t n) -> void {
+        Guard g(*this);
+        drain_locked(c, n);
+    }
+
+    // On a poisoned segment the blocks are dropped instead of freed
+    auto drain_locked(Cache& c, uint32_t n) -> void {
+        bool drop = poisoned();
+        while (n-- && c.count) {
+            uint32_t off = c.blocks[--c.count];
+            if (!drop) tlsf_.free(off);
+        }
+    }
+
+    TlsfAllocator tlsf_;
+    uint32_t pid_;
+    Cache caches_[TLSF_CACHE_CLASSES];
+};
+
+} // namespace hftshm
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "hash.hpp"
+#include "ring.hpp"
+
+namespace hftshm {
+
+// ============================================================================
+// Partition Naming and Routing
+// ============================================================================
+
+// A topic "md" with 4 partitions is stored as rings md.p0 .. md.p3,
+// each with its own .hdr/.dat segments.
+inline std::string partition_name(std::string_view topic, uint32_t partition) {
+    return std::string(topic) + ".p" + std::to_string(partition);
+}
+
+// Partition for a key; any partition count, no modulo
+inline constexpr uint32_t partition_for(uint32_t key, uint32_t partitions) {
+    return static_cast<uint32_t>((static_cast<uint64_t>(key_hash(key)) * partitions) >> 32);
+}
+
+// ============================================================================
+// Topic Producer
+// ============================================================================
+
+// Producer for the partitions of a topic owned by this process.
+// Several producer processes can split the partitions between them; events
+// for a key always land in the same partition, which preserves per-key order.
+class TopicProducer {
+public:
+    explicit TopicProducer(uint32_t partitions)
+        : rings_(partitions) {}
+
+    // Take ownership of partition `index` (mapped header and data segments)
+    auto add_partition(uint32_t index, void* header, void* data) -> void {
+        rings_.at(index).emplace(header, data);
+    }
+
+    auto partition_of(uint32_t key) const -> uint32_t {
+        return partition_for(key, partitions());
+    }
+
+    auto owns(uint32_t key) const -> bool {
+        return rings_[partition_of(key)].has_value();
+    }
+
+    // Slot in the key's partition, nullptr if full or not owned by this producer
+    auto try_claim(uint32_t key) -> void* {
+        auto& ring = rings_[partition_of(key)];
+        return ring ? ring->try_claim() : nullptr;
+    }
+
+    // Publish the slot returned by try_claim(key); false if the key's
+    // partition is not owned by this producer
+    auto publish(uint32_t key) -> bool {
+        auto& ring = rings_[partition_of(key)];
+        if (!ring) return false;
+        ring->publish();
+        return true;
+    }
+
+    auto try_write(const void* event, std::size_t size, uint32_t key) -> bool {
+        auto& ring = rings_[partition_of(key)];
+        return ring && ring->try_write(event, size);
+    }
+
+    auto partitions() const -> uint32_t { return static_cast<uint32_t>(rings_.size()); }
+
+private:
+    std::vector<std::optional<RingProducer>> rings_;
+};
+
+// ============================================================================
+// Topic Consumer
+// ============================================================================
+
+// Consumer attached to one, several or all partitions of a topic.
+// Partitions are drained round-robin; order is preserved per partition,
+// hence per key, but not across partitions.
+class TopicConsumer {
+public:
+    // Attach to partition `index` using its consumer section `consumer_id`
+    auto add_partition(uint32_t index, void* header, void* data, uint8_t consumer_id) -> void {
+        parts_.push_back({index, RingConsumer(header, data, consumer_id)});
+        parts_.back().ring.attach();
+    }
+
+    auto detach() -> void {
+        for (auto& p : parts_) p.ring.detach();
+    }
+
+    // Invoke fn(const void* event, uint32_t partition) for up to
+    // max_per_partition events from each attached partition
+    template <typename F>
+    auto poll(F&& fn, uint64_t max_per_partition = UINT64_MAX) -> uint64_t {
+        uint64_t total = 0;
+        const std::size_t n = parts_.size();
+        for (std::size_t i = 0; i < n; ++i) {
+            auto& p = parts_[(next_ + i) % n];
+            total += p.ring.poll([&](const void* event) { fn(event, p.index); }, max_per_partition);
+        }
+        if (n) next_ = (next_ + 1) % n;
+        return total;
+    }
+
+    auto available() -> uint64_t {
+        uint64_t total = 0;
+        for (auto& p : parts_) total += p.ring.available();
+        return total;
+    }
+
+private:
+    struct Partition {
+        uint32_t index;
+        RingConsumer ring;
+    };
+
+    std::vector<Partition> parts_;
+    std::size_t next_ = 0;      // Round-robin start
+};
+
+} // namespace hftshm
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace hftshm {
+
+// ============================================================================
+// CPU Relax
+// ============================================================================
+
+// Spin-loop hint: frees pipeline resources for the sibling hyperthread
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+// ============================================================================
+// Wait Strategies
+// ============================================================================
+
+// A wait strategy's idle(n) is called with the number of consecutive
+// unsuccessful polls so far; it decides how to back off.
+
+// Lowest latency; burns a core
+struct BusySpinWait {
+    auto idle(uint32_t /*attempt*/) const -> void { cpu_relax(); }
+};
+
+// Spin, then yield the core to other runnable threads
+struct YieldingWait {
+    uint32_t spin_tries = 100;
+
+    auto idle(uint32_t attempt) const -> void {
+        if (attempt < spin_tries) {
+            cpu_relax();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+};
+
+// Spin, yield, then sleep; for consumers that tolerate tens of microseconds
+struct SleepingWait {
+    uint32_t spin_tries = 100;
+    uint32_t yield_tries = 100;
+    std::chrono::nanoseconds sleep = std::chrono::microseconds(50);
+
+    auto idle(uint32_t attempt) const -> void {
+        if (attempt < spin_tries) {
+            cpu_relax();
+        } else if (attempt < spin_tries + yield_tries) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(sleep);
+        }
+    }
+};
+
+// Poll `ready()` until it returns true or `timeout` elapses.
+// The clock is read only every 64 attempts to keep the spin path cheap.
+template <typename Wait, typename Pred>
+inline auto wait_until(Pred&& ready, const Wait& wait, std::chrono::nanoseconds timeout) -> bool {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    for (uint32_t attempt = 0;; ++attempt) {
+        if (ready()) return true;
+        if ((attempt & 63) == 63 && std::chrono::steady_clock::now() >= deadline) return false;
+        wait.idle(attempt);
+    }
+}
+
+} // namespace hftshm